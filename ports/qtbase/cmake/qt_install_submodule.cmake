@@ -265,14 +265,18 @@ function(qt_fixup_and_cleanup)
         endif()
     endforeach()
 
+    set(_config_packages "")
     foreach(_comp IN LISTS COMPONENTS)
         if(EXISTS "${CURRENT_PACKAGES_DIR}/share/Qt6${_comp}")
-            vcpkg_cmake_config_fixup(PACKAGE_NAME "Qt6${_comp}" CONFIG_PATH "share/Qt6${_comp}" TOOLS_PATH "tools/Qt6/bin")
+            list(APPEND _config_packages "Qt6${_comp}")
             # Would rather put it into share/cmake as before but the import_prefix correction in vcpkg_cmake_config_fixup is working against that.
         else()
             message(STATUS "WARNING: Qt component ${_comp} not found/built!")
         endif()
     endforeach()
+    if(_config_packages)
+        vcpkg_cmake_config_fixup(PACKAGE_NAMES ${_config_packages} TOOLS_PATH "tools/Qt6/bin")
+    endif()
     #fix debug plugin paths (should probably be fixed in vcpkg_cmake_config_fixup)
     file(GLOB_RECURSE DEBUG_CMAKE_TARGETS "${CURRENT_PACKAGES_DIR}/share/**/*Targets-debug.cmake")
     debug_message("DEBUG_CMAKE_TARGETS:${DEBUG_CMAKE_TARGETS}")
@@ -290,6 +294,11 @@ function(qt_fixup_and_cleanup)
                              IGNORE_UNCHANGED)
     endforeach()
 
+    if(_config_packages)
+        # Single-file configs for consumers using X_VCPKG_CONSOLIDATED_CONFIGS
+        vcpkg_cmake_config_consolidate(PACKAGE_NAMES ${_config_packages})
+    endif()
+
     set(qt_tooldest "${CURRENT_PACKAGES_DIR}/tools/Qt6/bin")
     set(qt_searchdir "${CURRENT_PACKAGES_DIR}/bin")
     ## Handle Tools
@@ -1,9 +1,49 @@
 include_guard(GLOBAL)
 
+# Maps a boost port name to the name of its CMake package without the "boost_" prefix.
+function(z_vcpkg_boost_config_name out_var port_name)
+  string(REPLACE "-" "_" config_name "${port_name}")
+  string(REPLACE "boost_" "" config_name "${config_name}")
+  if(port_name MATCHES "^boost-(ublas|odeint|interval)\$")
+    set(config_name "numeric_${config_name}")
+  endif()
+  set("${out_var}" "${config_name}" PARENT_SCOPE)
+endfunction()
+
+# Reads the boost dependencies of the current port from its manifest.
+# Leaves out_var undefined if a dependency is conditional, in which case the CMake build is needed.
+function(z_vcpkg_boost_header_only_dependencies out_var)
+  file(READ "${CURRENT_PORT_DIR}/vcpkg.json" manifest)
+  string(JSON count ERROR_VARIABLE error LENGTH "${manifest}" dependencies)
+  if(error)
+    set(count 0)
+  endif()
+  set(dependencies "")
+  if(count GREATER 0)
+    math(EXPR last "${count} - 1")
+    foreach(i RANGE ${last})
+      string(JSON dependency GET "${manifest}" dependencies ${i})
+      if(dependency MATCHES "^[{]")
+        string(JSON platform ERROR_VARIABLE error GET "${dependency}" platform)
+        if(NOT error)
+          return()
+        endif()
+        string(JSON dependency GET "${dependency}" name)
+      endif()
+      if(dependency MATCHES "^boost-" AND NOT dependency MATCHES "^boost-(cmake|headers|uninstall)\$")
+        z_vcpkg_boost_config_name(config_name "${dependency}")
+        list(APPEND dependencies "${config_name}")
+      endif()
+    endforeach()
+  endif()
+  set("${out_var}" "${dependencies}" PARENT_SCOPE)
+endfunction()
+
 function(boost_configure_and_install)
   cmake_parse_arguments(PARSE_ARGV 0 "arg" "" "SOURCE_PATH" "OPTIONS")
 
   string(REPLACE "-" "_" boost_lib_name "${PORT}")
+  set(PORT_UNDERSCORE "${boost_lib_name}")
   string(REPLACE "boost_" "" boost_lib_name "${boost_lib_name}")
   set(boost_lib_name_config "${boost_lib_name}")
 
@@ -34,6 +74,32 @@ function(boost_configure_and_install)
   # Beta builds contains a text in the version string
   string(REGEX MATCH "([0-9]+)\\.([0-9]+)\\.([0-9]+)" SEMVER_VERSION "${VERSION}")
 
+  if(headers_only AND VCPKG_BOOST_FAST_HEADER_ONLY AND "${arg_OPTIONS}" STREQUAL "" AND NOT Z_VCPKG_BOOST_FORCE_HEADER_ONLY)
+    z_vcpkg_boost_header_only_dependencies(boost_dependencies)
+    if(DEFINED boost_dependencies)
+      set(boost_link_libraries "")
+      foreach(dependency IN LISTS boost_dependencies)
+        list(APPEND boost_link_libraries "Boost::${dependency}")
+      endforeach()
+      list(TRANSFORM boost_dependencies PREPEND "boost_")
+      list(TRANSFORM boost_dependencies APPEND " ${SEMVER_VERSION} EXACT")
+      set(BOOST_PORT_NAME "${boost_lib_name_config}")
+      configure_file("${CURRENT_HOST_INSTALLED_DIR}/share/vcpkg-boost/usage.in" "${CURRENT_BUILDTREES_DIR}/usage")
+      vcpkg_install_header_only(
+        SOURCE_PATH "${arg_SOURCE_PATH}/${boost_lib_path}"
+        PACKAGE_NAME "boost_${boost_lib_name_config}"
+        TARGET "Boost::${boost_lib_name_config}"
+        VERSION "${SEMVER_VERSION}"
+        COMPATIBILITY ExactVersion
+        DEPENDENCIES ${boost_dependencies}
+        LINK_LIBRARIES ${boost_link_libraries}
+        USAGE "${CURRENT_BUILDTREES_DIR}/usage"
+      )
+      vcpkg_install_copyright(FILE_LIST "${CURRENT_INSTALLED_DIR}/share/boost-cmake/copyright")
+      return()
+    endif()
+  endif()
+
   file(WRITE "${arg_SOURCE_PATH}/CMakeLists.txt" "\
 cmake_minimum_required(VERSION 3.25)\n\
 project(Boost VERSION ${SEMVER_VERSION} LANGUAGES CXX)\n\
@@ -66,17 +132,29 @@ include(BoostRoot)\n"
   file(GLOB cmake_paths "${CURRENT_PACKAGES_DIR}/lib/cmake/*" LIST_DIRECTORIES true)
   file(GLOB cmake_files "${CURRENT_PACKAGES_DIR}/lib/cmake/*" LIST_DIRECTORIES false)
   list(REMOVE_ITEM cmake_paths "${cmake_files}" "${CURRENT_PACKAGES_DIR}/lib/cmake/boost_${boost_lib_name_config}-${SEMVER_VERSION}")
+  set(config_names "")
+  set(config_paths "")
   foreach(config_path IN LISTS cmake_paths)
     string(REPLACE "-${SEMVER_VERSION}" "" config_path "${config_path}")
     string(REPLACE "${CURRENT_PACKAGES_DIR}/lib/cmake/" "" config_name "${config_path}")
-    vcpkg_cmake_config_fixup(PACKAGE_NAME ${config_name} CONFIG_PATH lib/cmake/${config_name}-${SEMVER_VERSION} DO_NOT_DELETE_PARENT_CONFIG_PATH)
+    list(APPEND config_names "${config_name}")
+    list(APPEND config_paths "lib/cmake/${config_name}-${SEMVER_VERSION}")
   endforeach()
 
   if(PORT MATCHES "boost-(stacktrace|test)") 
     # These ports have no cmake config agreeing with the port name
+    if(config_names)
+      vcpkg_cmake_config_fixup(PACKAGE_NAMES ${config_names} CONFIG_PATHS ${config_paths} DO_NOT_DELETE_PARENT_CONFIG_PATH)
+    endif()
     file(REMOVE_RECURSE "${CURRENT_PACKAGES_DIR}/lib/cmake" "${CURRENT_PACKAGES_DIR}/debug/lib/cmake")
   else()
-    vcpkg_cmake_config_fixup(PACKAGE_NAME boost_${boost_lib_name_config} CONFIG_PATH lib/cmake/boost_${boost_lib_name_config}-${SEMVER_VERSION})
+    list(APPEND config_names "boost_${boost_lib_name_config}")
+    list(APPEND config_paths "lib/cmake/boost_${boost_lib_name_config}-${SEMVER_VERSION}")
+    vcpkg_cmake_config_fixup(PACKAGE_NAMES ${config_names} CONFIG_PATHS ${config_paths})
+  endif()
+  if(config_names)
+    # Single-file configs for consumers using X_VCPKG_CONSOLIDATED_CONFIGS
+    vcpkg_cmake_config_consolidate(PACKAGE_NAMES ${config_names})
   endif()
 
   if(headers_only)
@@ -1 +1,2 @@
 include("${CMAKE_CURRENT_LIST_DIR}/vcpkg_cmake_config_fixup.cmake")
+include("${CMAKE_CURRENT_LIST_DIR}/vcpkg_cmake_config_consolidate.cmake")
@@ -0,0 +1,148 @@
+include_guard(GLOBAL)
+
+# Writes share/<package>/<package>-consolidated.cmake for each package: the package config with the CMake
+# generated targets files it includes, and their per-configuration files, inlined. Consumers opt in with
+# X_VCPKG_CONSOLIDATED_CONFIGS in the vcpkg toolchain, which loads it instead of the package config.
+# Packages without a config file, and packages whose files cannot be inlined without changing their
+# meaning, are skipped.
+function(vcpkg_cmake_config_consolidate)
+    cmake_parse_arguments(PARSE_ARGV 0 "arg" "" "" "PACKAGE_NAMES")
+    if(DEFINED arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "vcpkg_cmake_config_consolidate was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+    if(NOT DEFINED arg_PACKAGE_NAMES)
+        message(FATAL_ERROR "PACKAGE_NAMES must be specified")
+    endif()
+
+    foreach(package_name IN LISTS arg_PACKAGE_NAMES)
+        set(config_dir "${CURRENT_PACKAGES_DIR}/share/${package_name}")
+        string(TOLOWER "${package_name}" lowercase_package_name)
+        set(config_file "")
+        foreach(candidate IN ITEMS "${package_name}Config" "${lowercase_package_name}-config")
+            if(EXISTS "${config_dir}/${candidate}.cmake")
+                set(config_file "${candidate}")
+                break()
+            endif()
+        endforeach()
+        if(config_file STREQUAL "")
+            # e.g. a boost library or Qt module without CMake config
+            message(STATUS "Not consolidating ${package_name}: no config file in ${config_dir}")
+            continue()
+        endif()
+
+        file(READ "${config_dir}/${config_file}.cmake" contents)
+        z_vcpkg_cmake_config_consolidate_includes(consolidated inlined_count "${config_dir}" "${contents}")
+        if(NOT inlined_count EQUAL "0")
+            file(WRITE "${config_dir}/${package_name}-consolidated.cmake" "${consolidated}")
+            # The version file is found by the name of the config file.
+            foreach(suffix IN ITEMS "Version" "-version")
+                if(EXISTS "${config_dir}/${config_file}${suffix}.cmake")
+                    file(COPY_FILE "${config_dir}/${config_file}${suffix}.cmake" "${config_dir}/${package_name}-consolidated-version.cmake")
+                    break()
+                endif()
+            endforeach()
+        else()
+            debug_message("${package_name}: no targets files to consolidate")
+        endif()
+    endforeach()
+endfunction()
+
+# Replaces include("${CMAKE_CURRENT_LIST_DIR}/<file>") of CMake generated targets files with their contents.
+# Files in subdirectories stay included: their CMAKE_CURRENT_LIST_DIR and _IMPORT_PREFIX would change.
+function(z_vcpkg_cmake_config_consolidate_includes out_var out_count config_dir contents)
+    set(include_regex "include\\(\"\\\${CMAKE_CURRENT_LIST_DIR}/([^\"$/]+\\.cmake)\"\\)")
+    set(result "")
+    set(count 0)
+    while(contents MATCHES "${include_regex}")
+        set(include_command "${CMAKE_MATCH_0}")
+        set(included_file "${config_dir}/${CMAKE_MATCH_1}")
+        string(FIND "${contents}" "${include_command}" index)
+        string(SUBSTRING "${contents}" 0 "${index}" before)
+        string(LENGTH "${include_command}" length)
+        math(EXPR index "${index} + ${length}")
+        string(SUBSTRING "${contents}" "${index}" -1 contents)
+        string(APPEND result "${before}")
+
+        set(inlined "")
+        if(EXISTS "${included_file}")
+            z_vcpkg_cmake_config_consolidate_targets(inlined "${included_file}")
+        endif()
+        if(inlined STREQUAL "")
+            string(APPEND result "${include_command}")
+        else()
+            string(APPEND result "${inlined}")
+            math(EXPR count "${count} + 1")
+        endif()
+    endwhile()
+    string(APPEND result "${contents}")
+    set("${out_var}" "${result}" PARENT_SCOPE)
+    set("${out_count}" "${count}" PARENT_SCOPE)
+endfunction()
+
+# Returns the contents of a CMake generated targets file, with its per-configuration files inlined,
+# as a block which can replace its include(). Returns an empty string for any other file.
+function(z_vcpkg_cmake_config_consolidate_targets out_var targets_file)
+    set("${out_var}" "" PARENT_SCOPE)
+    file(READ "${targets_file}" contents)
+    if(NOT contents MATCHES "\n# Generated CMake target import file\\.\n")
+        return()
+    endif()
+
+    # Inline the files which the targets file loads for each installed configuration.
+    set(load_regex "file\\(GLOB ([A-Za-z_]+) \"\\\${(CMAKE_CURRENT_LIST_DIR|_DIR)}/([^\"/*]+\\*\\.cmake)\"\\)\nforeach\\(([A-Za-z_]+) (IN LISTS [A-Za-z_]+|\\\${[A-Za-z_]+})\\)\n *include\\(\"?\\\${[A-Za-z_]+}\"?\\)\nendforeach\\(\\)\n")
+    if(NOT contents MATCHES "${load_regex}")
+        return()
+    endif()
+    set(load_block "${CMAKE_MATCH_0}")
+    get_filename_component(targets_dir "${targets_file}" DIRECTORY)
+    file(GLOB configuration_files "${targets_dir}/${CMAKE_MATCH_3}")
+    list(SORT configuration_files)
+    set(configuration_contents "")
+    foreach(configuration_file IN LISTS configuration_files)
+        file(READ "${configuration_file}" configuration_file_contents)
+        if(configuration_file_contents MATCHES "(^|\n) *return\\(|CMAKE_CURRENT_(LIST|FUNCTION)")
+            return()
+        endif()
+        get_filename_component(configuration_file_name "${configuration_file}" NAME)
+        string(APPEND configuration_contents "# Inlined ${configuration_file_name}\n${configuration_file_contents}")
+    endforeach()
+    string(REPLACE "${load_block}" "${configuration_contents}" contents "${contents}")
+
+    # The targets file returns early when its targets exist already. Run it as a loop body and break instead.
+    # This is only possible when no return() is nested in another block.
+    string(ASCII 1 semicolon)
+    string(ASCII 2 open_bracket)
+    string(ASCII 3 close_bracket)
+    string(REPLACE ";" "${semicolon}" contents "${contents}")
+    string(REPLACE "[" "${open_bracket}" contents "${contents}")
+    string(REPLACE "]" "${close_bracket}" contents "${contents}")
+    string(REPLACE "\n" ";" lines "${contents}")
+    set(depth 0)
+    set(block_lines "")
+    foreach(line IN LISTS lines)
+        if(line MATCHES "^ *(foreach|while|function|macro) *\\(")
+            math(EXPR depth "${depth} + 1")
+        elseif(line MATCHES "^ *(endforeach|endwhile|endfunction|endmacro) *\\(")
+            math(EXPR depth "${depth} - 1")
+        elseif(line MATCHES "^( *)return *\\( *\\)$")
+            if(NOT depth EQUAL "0")
+                return()
+            endif()
+            set(line "${CMAKE_MATCH_1}break()")
+        elseif(line MATCHES "CMAKE_CURRENT_FUNCTION")
+            return()
+        endif()
+        list(APPEND block_lines "${line}")
+    endforeach()
+    list(JOIN block_lines "\n" contents)
+    string(REPLACE "${semicolon}" ";" contents "${contents}")
+    string(REPLACE "${open_bracket}" "[" contents "${contents}")
+    string(REPLACE "${close_bracket}" "]" contents "${contents}")
+
+    get_filename_component(targets_file_name "${targets_file}" NAME)
+    set("${out_var}" "# Inlined ${targets_file_name}
+foreach(z_vcpkg_consolidated_block IN ITEMS ${targets_file_name})
+${contents}
+endforeach()
+unset(z_vcpkg_consolidated_block)" PARENT_SCOPE)
+endfunction()
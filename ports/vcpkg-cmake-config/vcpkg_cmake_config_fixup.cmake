@@ -1,98 +1,163 @@
 include_guard(GLOBAL)
 
 function(vcpkg_cmake_config_fixup)
-    cmake_parse_arguments(PARSE_ARGV 0 "arg" "DO_NOT_DELETE_PARENT_CONFIG_PATH;NO_PREFIX_CORRECTION" "PACKAGE_NAME;CONFIG_PATH;TOOLS_PATH" "")
+    cmake_parse_arguments(PARSE_ARGV 0 "arg" "DO_NOT_DELETE_PARENT_CONFIG_PATH;NO_PREFIX_CORRECTION" "PACKAGE_NAME;CONFIG_PATH;TOOLS_PATH" "PACKAGE_NAMES;CONFIG_PATHS")
 
     if(DEFINED arg_UNPARSED_ARGUMENTS)
         message(FATAL_ERROR "vcpkg_cmake_config_fixup was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
     endif()
-    if(NOT arg_PACKAGE_NAME)
-        set(arg_PACKAGE_NAME "${PORT}")
-    endif()
-    if(NOT arg_CONFIG_PATH)
-        set(arg_CONFIG_PATH "share/${arg_PACKAGE_NAME}")
+    if(DEFINED arg_PACKAGE_NAMES)
+        if(DEFINED arg_PACKAGE_NAME OR DEFINED arg_CONFIG_PATH)
+            message(FATAL_ERROR "PACKAGE_NAMES cannot be combined with PACKAGE_NAME or CONFIG_PATH")
+        endif()
+        set(package_names "${arg_PACKAGE_NAMES}")
+        if(DEFINED arg_CONFIG_PATHS)
+            list(LENGTH arg_PACKAGE_NAMES package_count)
+            list(LENGTH arg_CONFIG_PATHS config_path_count)
+            if(NOT package_count EQUAL config_path_count)
+                message(FATAL_ERROR "CONFIG_PATHS must have one entry for each of PACKAGE_NAMES")
+            endif()
+            set(config_paths "${arg_CONFIG_PATHS}")
+        else()
+            set(config_paths "${arg_PACKAGE_NAMES}")
+            list(TRANSFORM config_paths PREPEND "share/")
+        endif()
+    elseif(DEFINED arg_CONFIG_PATHS)
+        message(FATAL_ERROR "CONFIG_PATHS requires PACKAGE_NAMES")
+    else()
+        if(NOT arg_PACKAGE_NAME)
+            set(arg_PACKAGE_NAME "${PORT}")
+        endif()
+        if(NOT arg_CONFIG_PATH)
+            set(arg_CONFIG_PATH "share/${arg_PACKAGE_NAME}")
+        endif()
+        set(package_names "${arg_PACKAGE_NAME}")
+        set(config_paths "${arg_CONFIG_PATH}")
     endif()
     if(NOT arg_TOOLS_PATH)
         set(arg_TOOLS_PATH "tools/${PORT}")
     endif()
-    set(target_path "share/${arg_PACKAGE_NAME}")
 
     string(REPLACE "." "\\." EXECUTABLE_SUFFIX "${VCPKG_TARGET_EXECUTABLE_SUFFIX}")
+    set(with_debug OFF)
+    if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "debug")
+        set(with_debug ON)
+    endif()
 
-    set(debug_share "${CURRENT_PACKAGES_DIR}/debug/${target_path}")
-    set(release_share "${CURRENT_PACKAGES_DIR}/${target_path}")
-
-    if(NOT arg_CONFIG_PATH STREQUAL "share/${arg_PACKAGE_NAME}")
-        if(arg_CONFIG_PATH STREQUAL "share")
-            set(arg_CONFIG_PATH z_vcpkg_share)
-            file(RENAME "${CURRENT_PACKAGES_DIR}/debug/share" "${CURRENT_PACKAGES_DIR}/debug/${arg_CONFIG_PATH}")
-            file(RENAME "${CURRENT_PACKAGES_DIR}/share" "${CURRENT_PACKAGES_DIR}/${arg_CONFIG_PATH}")
-        endif()
-
-        set(debug_config "${CURRENT_PACKAGES_DIR}/debug/${arg_CONFIG_PATH}")
-        set(release_config "${CURRENT_PACKAGES_DIR}/${arg_CONFIG_PATH}")
-        if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "debug")
-            if(NOT EXISTS "${debug_config}")
-                message(FATAL_ERROR "'${debug_config}' does not exist.")
-            endif()
+    # Move all config directories first, then fix up the files of all packages.
+    set(removed_config_dirs "")
+    foreach(package_name config_path IN ZIP_LISTS package_names config_paths)
+        z_vcpkg_cmake_config_fixup_move_config("${package_name}" "${config_path}" removed_config_dirs)
+    endforeach()
+    if(NOT arg_DO_NOT_DELETE_PARENT_CONFIG_PATH AND NOT removed_config_dirs STREQUAL "")
+        file(REMOVE_RECURSE ${removed_config_dirs})
+    endif()
 
-            # This roundabout handling enables CONFIG_PATH = share
-            file(MAKE_DIRECTORY "${debug_share}")
-            file(GLOB files "${debug_config}/*")
-            file(COPY ${files} DESTINATION "${debug_share}")
-            file(REMOVE_RECURSE "${debug_config}")
-        endif()
+    if(NOT DEFINED Z_VCPKG_CMAKE_CONFIG_ALREADY_FIXED_UP)
+        vcpkg_list(SET Z_VCPKG_CMAKE_CONFIG_ALREADY_FIXED_UP)
+    endif()
+    foreach(package_name IN LISTS package_names)
+        z_vcpkg_cmake_config_fixup_files("${package_name}")
+    endforeach()
+    set(Z_VCPKG_CMAKE_CONFIG_ALREADY_FIXED_UP "${Z_VCPKG_CMAKE_CONFIG_ALREADY_FIXED_UP}" CACHE INTERNAL "")
 
-        file(GLOB files "${release_config}/*")
-        file(COPY ${files} DESTINATION "${release_share}")
-        file(REMOVE_RECURSE "${release_config}")
+    # Remove /debug/share/ if it's empty.
+    file(GLOB_RECURSE remaining_files "${CURRENT_PACKAGES_DIR}/debug/share/*")
+    if(remaining_files STREQUAL "")
+        file(REMOVE_RECURSE "${CURRENT_PACKAGES_DIR}/debug/share")
+    endif()
+endfunction()
 
-        if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "debug")
-            get_filename_component(debug_config_dir_name "${debug_config}" NAME)
-            string(TOLOWER "${debug_config_dir_name}" debug_config_dir_name)
-            if(debug_config_dir_name STREQUAL "cmake" AND NOT arg_DO_NOT_DELETE_PARENT_CONFIG_PATH)
-                file(REMOVE_RECURSE "${debug_config}")
-            else()
-                get_filename_component(debug_config_parent_dir "${debug_config}" DIRECTORY)
-                get_filename_component(debug_config_dir_name "${debug_config_parent_dir}" NAME)
-                string(TOLOWER "${debug_config_dir_name}" debug_config_dir_name)
-                if(debug_config_dir_name STREQUAL "cmake" AND NOT arg_DO_NOT_DELETE_PARENT_CONFIG_PATH)
-                    file(REMOVE_RECURSE "${debug_config_parent_dir}")
-                endif()
-            endif()
+# Moves a directory tree into destination, by renaming whole directories where possible.
+# Files which already exist in destination are replaced.
+function(z_vcpkg_cmake_config_fixup_move source destination)
+    if(NOT EXISTS "${source}")
+        return()
+    endif()
+    if(NOT EXISTS "${destination}")
+        get_filename_component(destination_parent "${destination}" DIRECTORY)
+        file(MAKE_DIRECTORY "${destination_parent}")
+        file(RENAME "${source}" "${destination}" RESULT rename_result)
+        if(rename_result STREQUAL "0")
+            return()
         endif()
-
-        get_filename_component(release_config_dir_name "${release_config}" NAME)
-        string(TOLOWER "${release_config_dir_name}" release_config_dir_name)
-        if(release_config_dir_name STREQUAL "cmake" AND NOT arg_DO_NOT_DELETE_PARENT_CONFIG_PATH)
-            file(REMOVE_RECURSE "${release_config}")
+        file(MAKE_DIRECTORY "${destination}")
+    endif()
+    file(GLOB entries LIST_DIRECTORIES true "${source}/*")
+    foreach(entry IN LISTS entries)
+        get_filename_component(name "${entry}" NAME)
+        if(IS_DIRECTORY "${entry}" AND NOT IS_SYMLINK "${entry}" AND IS_DIRECTORY "${destination}/${name}")
+            z_vcpkg_cmake_config_fixup_move("${entry}" "${destination}/${name}")
         else()
-            get_filename_component(release_config_parent_dir "${release_config}" DIRECTORY)
-            get_filename_component(release_config_dir_name "${release_config_parent_dir}" NAME)
-            string(TOLOWER "${release_config_dir_name}" release_config_dir_name)
-            if(release_config_dir_name STREQUAL "cmake" AND NOT arg_DO_NOT_DELETE_PARENT_CONFIG_PATH)
-                file(REMOVE_RECURSE "${release_config_parent_dir}")
+            file(RENAME "${entry}" "${destination}/${name}" RESULT rename_result)
+            if(NOT rename_result STREQUAL "0")
+                file(COPY "${entry}" DESTINATION "${destination}")
             endif()
         endif()
+    endforeach()
+    file(REMOVE_RECURSE "${source}")
+endfunction()
+
+# Moves CONFIG_PATH of one package to share/<package_name>, for release and debug.
+# Appends the emptied cmake directories which are to be removed to out_removed_dirs.
+function(z_vcpkg_cmake_config_fixup_move_config package_name config_path out_removed_dirs)
+    set(target_path "share/${package_name}")
+    if(config_path STREQUAL target_path)
+        return()
     endif()
+    set(debug_share "${CURRENT_PACKAGES_DIR}/debug/${target_path}")
+    set(release_share "${CURRENT_PACKAGES_DIR}/${target_path}")
 
-    if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "debug")
-        if(NOT EXISTS "${debug_share}")
-            message(FATAL_ERROR "'${debug_share}' does not exist.")
+    if(config_path STREQUAL "share")
+        set(config_path z_vcpkg_share)
+        file(RENAME "${CURRENT_PACKAGES_DIR}/debug/share" "${CURRENT_PACKAGES_DIR}/debug/${config_path}")
+        file(RENAME "${CURRENT_PACKAGES_DIR}/share" "${CURRENT_PACKAGES_DIR}/${config_path}")
+    endif()
+
+    set(removed_dirs "${${out_removed_dirs}}")
+    set(configs "${CURRENT_PACKAGES_DIR}/${config_path}")
+    set(shares "${release_share}")
+    if(with_debug)
+        set(debug_config "${CURRENT_PACKAGES_DIR}/debug/${config_path}")
+        if(NOT EXISTS "${debug_config}")
+            message(FATAL_ERROR "'${debug_config}' does not exist.")
         endif()
+        list(PREPEND configs "${debug_config}")
+        list(PREPEND shares "${debug_share}")
     endif()
+    foreach(config share IN ZIP_LISTS configs shares)
+        z_vcpkg_cmake_config_fixup_move("${config}" "${share}")
+        if(share STREQUAL debug_share)
+            file(MAKE_DIRECTORY "${debug_share}")
+        endif()
 
-    file(GLOB_RECURSE release_targets
-        "${release_share}/*-release.cmake"
-    )
-    foreach(release_target IN LISTS release_targets)
-        file(READ "${release_target}" contents)
-        string(REPLACE "${CURRENT_INSTALLED_DIR}" "\${_IMPORT_PREFIX}" contents "${contents}")
-        string(REGEX REPLACE "\\\${_IMPORT_PREFIX}/bin/([^ \"]+${EXECUTABLE_SUFFIX})" "\${_IMPORT_PREFIX}/${arg_TOOLS_PATH}/\\1" contents "${contents}")
-        file(WRITE "${release_target}" "${contents}")
+        get_filename_component(config_dir_name "${config}" NAME)
+        string(TOLOWER "${config_dir_name}" config_dir_name)
+        if(NOT config_dir_name STREQUAL "cmake")
+            get_filename_component(config_parent_dir "${config}" DIRECTORY)
+            get_filename_component(config_dir_name "${config_parent_dir}" NAME)
+            string(TOLOWER "${config_dir_name}" config_dir_name)
+            if(config_dir_name STREQUAL "cmake")
+                list(APPEND removed_dirs "${config_parent_dir}")
+            endif()
+        endif()
     endforeach()
+    set("${out_removed_dirs}" "${removed_dirs}" PARENT_SCOPE)
+endfunction()
 
-    if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "debug")
+# Fixes the import files of share/<package_name>. Each file is read and written once;
+# debug import files are converted in memory and written to the release directory.
+function(z_vcpkg_cmake_config_fixup_files package_name)
+    set(target_path "share/${package_name}")
+    set(debug_share "${CURRENT_PACKAGES_DIR}/debug/${target_path}")
+    set(release_share "${CURRENT_PACKAGES_DIR}/${target_path}")
+    if(with_debug AND NOT EXISTS "${debug_share}")
+        message(FATAL_ERROR "'${debug_share}' does not exist.")
+    endif()
+
+    file(GLOB_RECURSE main_cmakes "${release_share}/*.cmake")
+    set(converted_debug_targets "")
+    if(with_debug)
         file(GLOB_RECURSE debug_targets
             "${debug_share}/*-debug.cmake"
             )
@@ -104,26 +169,40 @@ function(vcpkg_cmake_config_fixup)
             string(REGEX REPLACE "\\\${_IMPORT_PREFIX}/bin/([^ \";]+${EXECUTABLE_SUFFIX})" "\${_IMPORT_PREFIX}/${arg_TOOLS_PATH}/\\1" contents "${contents}")
             string(REPLACE "\${_IMPORT_PREFIX}/lib" "\${_IMPORT_PREFIX}/debug/lib" contents "${contents}")
             string(REPLACE "\${_IMPORT_PREFIX}/bin" "\${_IMPORT_PREFIX}/debug/bin" contents "${contents}")
-            file(WRITE "${release_share}/${debug_target_rel}" "${contents}")
+            set("z_vcpkg_contents_${release_share}/${debug_target_rel}" "${contents}")
+            list(APPEND converted_debug_targets "${release_share}/${debug_target_rel}")
 
             file(REMOVE "${debug_target}")
         endforeach()
+        list(APPEND main_cmakes ${converted_debug_targets})
+        list(REMOVE_DUPLICATES main_cmakes)
+        list(SORT main_cmakes)
     endif()
 
     #Fix ${_IMPORT_PREFIX} and absolute paths in cmake generated targets and configs;
     #Since those can be renamed we have to check in every *.cmake, but only once.
-    file(GLOB_RECURSE main_cmakes "${release_share}/*.cmake")
-    if(NOT DEFINED Z_VCPKG_CMAKE_CONFIG_ALREADY_FIXED_UP)
-        vcpkg_list(SET Z_VCPKG_CMAKE_CONFIG_ALREADY_FIXED_UP)
-    endif()
-    foreach(already_fixed_up IN LISTS Z_VCPKG_CMAKE_CONFIG_ALREADY_FIXED_UP)
-        vcpkg_list(REMOVE_ITEM main_cmakes "${already_fixed_up}")
-    endforeach()
-    vcpkg_list(APPEND Z_VCPKG_CMAKE_CONFIG_ALREADY_FIXED_UP ${main_cmakes})
-    set(Z_VCPKG_CMAKE_CONFIG_ALREADY_FIXED_UP "${Z_VCPKG_CMAKE_CONFIG_ALREADY_FIXED_UP}" CACHE INTERNAL "")
-
+    set(already_fixed_up "${Z_VCPKG_CMAKE_CONFIG_ALREADY_FIXED_UP}")
     foreach(main_cmake IN LISTS main_cmakes)
-        file(READ "${main_cmake}" contents)
+        if(main_cmake IN_LIST converted_debug_targets)
+            set(contents "${z_vcpkg_contents_${main_cmake}}")
+            set(write_contents ON)
+        else()
+            file(READ "${main_cmake}" contents)
+            set(original_contents "${contents}")
+            set(write_contents OFF)
+        endif()
+        if(main_cmake MATCHES "-release\\.cmake\$")
+            string(REPLACE "${CURRENT_INSTALLED_DIR}" "\${_IMPORT_PREFIX}" contents "${contents}")
+            string(REGEX REPLACE "\\\${_IMPORT_PREFIX}/bin/([^ \"]+${EXECUTABLE_SUFFIX})" "\${_IMPORT_PREFIX}/${arg_TOOLS_PATH}/\\1" contents "${contents}")
+        endif()
+        if(main_cmake IN_LIST already_fixed_up)
+            if(write_contents OR NOT contents STREQUAL original_contents)
+                file(WRITE "${main_cmake}" "${contents}")
+            endif()
+            continue()
+        endif()
+        vcpkg_list(APPEND Z_VCPKG_CMAKE_CONFIG_ALREADY_FIXED_UP "${main_cmake}")
+
         # Note: I think the following comment is no longer true, since we now require the path to be `share/blah`
         # however, I don't know it for sure.
         # - nimazzuc
@@ -199,8 +278,11 @@ get_filename_component(_IMPORT_PREFIX "${_IMPORT_PREFIX}" PATH)]]
             string(PREPEND contents "get_filename_component(VCPKG_IMPORT_PREFIX \"\${CMAKE_CURRENT_LIST_DIR}\/${relative}\" ABSOLUTE)\n")
         endif()
 
-        file(WRITE "${main_cmake}" "${contents}")
+        if(write_contents OR NOT contents STREQUAL original_contents)
+            file(WRITE "${main_cmake}" "${contents}")
+        endif()
     endforeach()
+    set(Z_VCPKG_CMAKE_CONFIG_ALREADY_FIXED_UP "${Z_VCPKG_CMAKE_CONFIG_ALREADY_FIXED_UP}" PARENT_SCOPE)
 
     file(GLOB_RECURSE unused_files
         "${debug_share}/*[Tt]argets.cmake"
@@ -217,12 +299,6 @@ get_filename_component(_IMPORT_PREFIX "${_IMPORT_PREFIX}" PATH)]]
     if(remaining_files STREQUAL "")
         file(REMOVE_RECURSE "${debug_share}")
     endif()
-
-    # Remove /debug/share/ if it's empty.
-    file(GLOB_RECURSE remaining_files "${CURRENT_PACKAGES_DIR}/debug/share/*")
-    if(remaining_files STREQUAL "")
-        file(REMOVE_RECURSE "${CURRENT_PACKAGES_DIR}/debug/share")
-    endif()
 endfunction()
 
 # Match a command from "<needle>" to ")\n". On match, returns the command and
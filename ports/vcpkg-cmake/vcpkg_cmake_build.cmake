@@ -6,6 +6,11 @@ function(vcpkg_cmake_build)
     if(DEFINED arg_UNPARSED_ARGUMENTS)
         message(FATAL_ERROR "vcpkg_cmake_build was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
     endif()
+
+    if(COMMAND z_vcpkg_adaptive_concurrency)
+        z_vcpkg_adaptive_concurrency(vcpkg_cmake_build)
+    endif()
+
     if(NOT DEFINED arg_LOGFILE_BASE)
         set(arg_LOGFILE_BASE "build")
     endif()
@@ -22,7 +27,11 @@ function(vcpkg_cmake_build)
             "/p:VCPkgLocalAppDataDisabled=true"
             "/p:UseIntelMKL=No"
         )
-        vcpkg_list(SET parallel_param "/m")
+        if(Z_VCPKG_ADAPTIVE_CONCURRENCY)
+            vcpkg_list(SET parallel_param "/m:${VCPKG_CONCURRENCY}")
+        else()
+            vcpkg_list(SET parallel_param "/m")
+        endif()
     elseif("${Z_VCPKG_CMAKE_GENERATOR}" STREQUAL "NMake Makefiles")
         # No options are currently added for nmake builds
     elseif(Z_VCPKG_CMAKE_GENERATOR STREQUAL "Unix Makefiles")
@@ -36,6 +45,15 @@ function(vcpkg_cmake_build)
         message(WARNING "Unrecognized GENERATOR setting from vcpkg_cmake_configure().")
     endif()
 
+    # VCPKG_AUDIT_DISABLE_PARALLEL builds DISABLE_PARALLEL ports with parallelism and without the
+    # serial fallback or retries, and records the outcome in parallel-audit-<triplet>.log.
+    set(audit_parallel OFF)
+    if(arg_DISABLE_PARALLEL AND VCPKG_AUDIT_DISABLE_PARALLEL)
+        message(STATUS "Auditing DISABLE_PARALLEL: building with parallelism enabled")
+        set(arg_DISABLE_PARALLEL OFF)
+        set(audit_parallel ON)
+    endif()
+
     vcpkg_list(SET target_param)
     if(arg_TARGET)
         vcpkg_list(SET target_param "--target" "${arg_TARGET}")
@@ -62,7 +80,20 @@ function(vcpkg_cmake_build)
                 endif()
             endif()
 
-            if(arg_DISABLE_PARALLEL)
+            set(audit_log "${CURRENT_BUILDTREES_DIR}/parallel-audit-${TARGET_TRIPLET}.log")
+            if(audit_parallel)
+                file(APPEND "${audit_log}" "vcpkg_cmake_build ${arg_LOGFILE_BASE}-${TARGET_TRIPLET}-${short_build_type}: started\n")
+                set(Z_VCPKG_EXECUTE_BUILD_PROCESS_NO_RETRY ON)
+                vcpkg_execute_build_process(
+                    COMMAND
+                        "${CMAKE_COMMAND}" --build . --config "${config}" ${target_param}
+                        -- ${build_param} ${parallel_param}
+                    WORKING_DIRECTORY "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${short_build_type}"
+                    LOGNAME "${arg_LOGFILE_BASE}-${TARGET_TRIPLET}-${short_build_type}"
+                )
+                file(APPEND "${audit_log}" "vcpkg_cmake_build ${arg_LOGFILE_BASE}-${TARGET_TRIPLET}-${short_build_type}: passed\n")
+                unset(Z_VCPKG_EXECUTE_BUILD_PROCESS_NO_RETRY)
+            elseif(arg_DISABLE_PARALLEL)
                 vcpkg_execute_build_process(
                     COMMAND
                         "${CMAKE_COMMAND}" --build . --config "${config}" ${target_param}
@@ -86,6 +117,10 @@ function(vcpkg_cmake_build)
             if(arg_ADD_BIN_TO_PATH)
                 vcpkg_restore_env_variables(VARS PATH)
             endif()
+
+            if("${arg_TARGET}" STREQUAL "install" AND COMMAND z_vcpkg_buildtree_reclaim)
+                z_vcpkg_buildtree_reclaim("${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${short_build_type}" "${TARGET_TRIPLET}-${short_build_type}")
+            endif()
         endif()
     endforeach()
 endfunction()
@@ -128,13 +128,6 @@ function(vcpkg_cmake_configure)
 
     set(build_dir_release "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel")
     set(build_dir_debug "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg")
-    file(REMOVE_RECURSE
-        "${build_dir_release}"
-        "${build_dir_debug}")
-    file(MAKE_DIRECTORY "${build_dir_release}")
-    if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "debug")
-        file(MAKE_DIRECTORY "${build_dir_debug}")
-    endif()
 
     if(DEFINED VCPKG_CMAKE_SYSTEM_NAME)
         vcpkg_list(APPEND arg_OPTIONS "-DCMAKE_SYSTEM_NAME=${VCPKG_CMAKE_SYSTEM_NAME}")
@@ -243,6 +236,67 @@ function(vcpkg_cmake_configure)
         "-DCMAKE_INSTALL_PREFIX=${CURRENT_PACKAGES_DIR}/debug"
         ${arg_OPTIONS} ${arg_OPTIONS_DEBUG})
 
+    set(build_dirs "${build_dir_release}")
+    if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "debug")
+        list(APPEND build_dirs "${build_dir_debug}")
+    endif()
+
+    # Editable incremental mode: keep the build directories of `vcpkg install --editable` and only
+    # configure again when the configure inputs changed. The toolchain fingerprint covers everything
+    # which requires a clean build directory, the options fingerprint the configure command lines.
+    set(clean_build_dirs ON)
+    set(incremental_stamp "")
+    if(NOT arg_Z_CMAKE_GET_VARS_USAGE AND _VCPKG_EDITABLE AND (VCPKG_EDITABLE_INCREMENTAL OR "$ENV{VCPKG_EDITABLE_INCREMENTAL}"))
+        set(incremental_stamp "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-editable-configure.txt")
+        set(toolchain_data "cmake=${CMAKE_VERSION}\ngenerator=${generator}\nbuild_type=${VCPKG_BUILD_TYPE}\n")
+        foreach(toolchain_file IN ITEMS "${SCRIPTS}/buildsystems/vcpkg.cmake" "${VCPKG_CHAINLOAD_TOOLCHAIN_FILE}" "${CMAKE_TRIPLET_FILE}")
+            if(NOT toolchain_file STREQUAL "" AND EXISTS "${toolchain_file}")
+                file(SHA512 "${toolchain_file}" toolchain_hash)
+                string(APPEND toolchain_data "${toolchain_file}=${toolchain_hash}\n")
+            endif()
+        endforeach()
+        string(SHA512 toolchain_hash "${toolchain_data}")
+        string(SHA512 options_hash "${rel_command}\n${dbg_command}\n${arg_DISABLE_PARALLEL_CONFIGURE}")
+        set(incremental_state "toolchain=${toolchain_hash}\noptions=${options_hash}\n")
+
+        set(previous_state "")
+        if(EXISTS "${incremental_stamp}")
+            file(READ "${incremental_stamp}" previous_state)
+        endif()
+        set(build_dirs_configured ON)
+        foreach(build_dir IN LISTS build_dirs)
+            if(NOT EXISTS "${build_dir}/CMakeCache.txt")
+                set(build_dirs_configured OFF)
+            endif()
+        endforeach()
+        file(REMOVE "${incremental_stamp}")
+        if(build_dirs_configured AND previous_state STREQUAL incremental_state)
+            message(STATUS "Configure inputs unchanged, reusing ${TARGET_TRIPLET} build directories")
+            file(WRITE "${incremental_stamp}" "${incremental_state}")
+            set(Z_VCPKG_CMAKE_GENERATOR "${generator}" CACHE INTERNAL "The generator which was used to configure CMake.")
+            return()
+        elseif(build_dirs_configured AND previous_state MATCHES "^toolchain=${toolchain_hash}\n")
+            # Configure from a fresh cache, but keep the objects for an incremental build.
+            message(STATUS "Configure options changed, reconfiguring ${TARGET_TRIPLET} build directories in place")
+            foreach(build_dir IN LISTS build_dirs)
+                file(REMOVE "${build_dir}/CMakeCache.txt")
+            endforeach()
+            file(REMOVE_RECURSE "${build_dir_release}/vcpkg-parallel-configure")
+            set(clean_build_dirs OFF)
+        endif()
+    endif()
+
+    if(clean_build_dirs)
+        file(REMOVE_RECURSE
+            "${build_dir_release}"
+            "${build_dir_debug}")
+        if(COMMAND z_vcpkg_buildtree_make_directories)
+            z_vcpkg_buildtree_make_directories(${build_dirs})
+        else()
+            file(MAKE_DIRECTORY ${build_dirs})
+        endif()
+    endif()
+
     if(NOT arg_DISABLE_PARALLEL_CONFIGURE)
         vcpkg_list(APPEND arg_OPTIONS "-DCMAKE_DISABLE_SOURCE_CHANGES=ON")
 
@@ -347,6 +401,9 @@ Please recheck them and remove the unnecessary options from the `vcpkg_cmake_con
 If these options should still be passed for whatever reason, please use the `MAYBE_UNUSED_VARIABLES` argument.")
     endif()
 
+    if(NOT incremental_stamp STREQUAL "")
+        file(WRITE "${incremental_stamp}" "${incremental_state}")
+    endif()
     if(NOT arg_Z_CMAKE_GET_VARS_USAGE)
         set(Z_VCPKG_CMAKE_GENERATOR "${generator}" CACHE INTERNAL "The generator which was used to configure CMake.")
     endif()
@@ -1,7 +1,7 @@
 include_guard(GLOBAL)
 
 function(vcpkg_cmake_install)
-    cmake_parse_arguments(PARSE_ARGV 0 "arg" "DISABLE_PARALLEL;ADD_BIN_TO_PATH" "" "")
+    cmake_parse_arguments(PARSE_ARGV 0 "arg" "DISABLE_PARALLEL;DISABLE_PARALLEL_INSTALL;ADD_BIN_TO_PATH" "" "")
     if(DEFINED arg_UNPARSED_ARGUMENTS)
         message(FATAL_ERROR "vcpkg_cmake_install was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
     endif()
@@ -13,6 +13,16 @@ function(vcpkg_cmake_install)
         endif()
     endforeach()
 
+    if(arg_DISABLE_PARALLEL_INSTALL AND NOT arg_DISABLE_PARALLEL)
+        # Only the install step is racy: build everything in parallel first,
+        # so that the serial install step has nothing left to compile.
+        vcpkg_cmake_build(
+            ${args}
+            LOGFILE_BASE build
+        )
+        list(APPEND args DISABLE_PARALLEL)
+    endif()
+
     vcpkg_cmake_build(
         ${args}
         LOGFILE_BASE install
@@ -1,5 +1,29 @@
 include_guard(GLOBAL)
 
+# Computes the name of the shared venv for a python interpreter and a set of requested packages.
+# The interpreter is identified by its resolved path, size and timestamp so that an upgraded
+# python gets a fresh venv.
+function(z_vcpkg_get_python_packages_venv_key out_var)
+    cmake_parse_arguments(PARSE_ARGV 1 arg "" "PYTHON_EXECUTABLE;REQUIREMENTS_FILE" "PACKAGES")
+
+    file(REAL_PATH "${arg_PYTHON_EXECUTABLE}" python_real_path)
+    file(SIZE "${python_real_path}" python_size)
+    file(TIMESTAMP "${python_real_path}" python_timestamp "%Y-%m-%dT%H:%M:%S" UTC)
+    set(key_data "python=${arg_PYTHON_EXECUTABLE}\nreal-path=${python_real_path}\nsize=${python_size}\ntimestamp=${python_timestamp}\n")
+
+    set(packages ${arg_PACKAGES})
+    list(SORT packages)
+    string(APPEND key_data "packages=${packages}\n")
+    if(NOT "${arg_REQUIREMENTS_FILE}" STREQUAL "")
+        file(SHA512 "${arg_REQUIREMENTS_FILE}" requirements_hash)
+        string(APPEND key_data "requirements=${requirements_hash}\n")
+    endif()
+
+    string(SHA512 key "${key_data}")
+    string(SUBSTRING "${key}" 0 16 key)
+    set("${out_var}" "${key}" PARENT_SCOPE)
+endfunction()
+
 function(x_vcpkg_get_python_packages)
     cmake_parse_arguments(PARSE_ARGV 0 arg "" "PYTHON_VERSION;PYTHON_EXECUTABLE;REQUIREMENTS_FILE;OUT_PYTHON_VAR" "PACKAGES")
 
@@ -67,50 +91,83 @@ function(x_vcpkg_get_python_packages)
                                            LOGNAME "easy-install-virtualenv-${TARGET_TRIPLET}")
         endif()
     endif()
-    set(venv_path "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-venv")
-    file(REMOVE_RECURSE "${venv_path}") # Remove old venv
-    file(MAKE_DIRECTORY "${venv_path}")
+    z_vcpkg_get_python_packages_venv_key(venv_key
+        PYTHON_EXECUTABLE "${arg_PYTHON_EXECUTABLE}"
+        REQUIREMENTS_FILE "${arg_REQUIREMENTS_FILE}"
+        PACKAGES ${arg_PACKAGES}
+    )
+    if(DEFINED X_VCPKG_PYTHON_VENV_CACHE_DIR)
+        set(venv_cache_dir "${X_VCPKG_PYTHON_VENV_CACHE_DIR}")
+    else()
+        set(venv_cache_dir "${DOWNLOADS}/tools/python-venvs")
+    endif()
+    if(X_VCPKG_PYTHON_VENV_NO_CACHE)
+        set(venv_path "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-venv")
+    else()
+        set(venv_path "${venv_cache_dir}/${venv_key}")
+    endif()
     if(CMAKE_HOST_WIN32)
-        file(MAKE_DIRECTORY "${python_dir}/DLLs")
         set(python_sub_path /Scripts)
-        set(python_venv virtualenv)
-        file(GLOB python_zipped_stdlib "${python_dir}/python3*.zip")
-        if(python_zipped_stdlib)
-            file(COPY ${python_zipped_stdlib} DESTINATION "${venv_path}/Scripts")
-        endif()
-        set(python_venv_options "--app-data" "${venv_path}/data")
     else()
         set(python_sub_path /bin)
-        if(arg_PYTHON_VERSION STREQUAL 3)
-            set(python_venv venv)
-        elseif(arg_PYTHON_VERSION STREQUAL 2)
+    endif()
+    set(${arg_OUT_PYTHON_VAR} "${venv_path}${python_sub_path}/python${VCPKG_HOST_EXECUTABLE_SUFFIX}")
+
+    # A cached venv is only ever written while holding its lock, and becomes
+    # visible to other ports once the stamp file exists. After that it is read-only.
+    set(venv_stamp "${venv_path}/vcpkg-venv-complete.txt")
+    if(NOT X_VCPKG_PYTHON_VENV_NO_CACHE)
+        file(MAKE_DIRECTORY "${venv_cache_dir}")
+        file(LOCK "${venv_path}.lock" GUARD FUNCTION)
+    endif()
+    if(NOT X_VCPKG_PYTHON_VENV_NO_CACHE AND EXISTS "${venv_stamp}")
+        message(STATUS "Using cached python virtual environment: ${venv_path}")
+    else()
+        file(REMOVE_RECURSE "${venv_path}") # Remove old or incomplete venv
+        file(MAKE_DIRECTORY "${venv_path}")
+        if(CMAKE_HOST_WIN32)
+            file(MAKE_DIRECTORY "${python_dir}/DLLs")
             set(python_venv virtualenv)
+            file(GLOB python_zipped_stdlib "${python_dir}/python3*.zip")
+            if(python_zipped_stdlib)
+                file(COPY ${python_zipped_stdlib} DESTINATION "${venv_path}/Scripts")
+            endif()
+            set(python_venv_options "--app-data" "${venv_path}/data")
+        else()
+            if(arg_PYTHON_VERSION STREQUAL 3)
+                set(python_venv venv)
+            elseif(arg_PYTHON_VERSION STREQUAL 2)
+                set(python_venv virtualenv)
+            endif()
+            set(python_venv_options --symlinks)
+        endif()
+
+        message(STATUS "Setting up python virtual environment...")
+        vcpkg_execute_required_process(COMMAND "${arg_PYTHON_EXECUTABLE}" -I -m "${python_venv}" ${python_venv_options} "${venv_path}"
+                                       WORKING_DIRECTORY "${CURRENT_BUILDTREES_DIR}"
+                                       LOGNAME "venv-setup-${TARGET_TRIPLET}")
+        if(DEFINED arg_REQUIREMENTS_FILE)
+            message(STATUS "Installing requirements from: ${arg_REQUIREMENTS_FILE}")
+            vcpkg_execute_required_process(COMMAND "${${arg_OUT_PYTHON_VAR}}" -I -m pip install -r ${arg_REQUIREMENTS_FILE}
+                                           WORKING_DIRECTORY "${CURRENT_BUILDTREES_DIR}"
+                                           LOGNAME "pip-install-requirements-file-${TARGET_TRIPLET}")
+        endif()
+        if(DEFINED arg_PACKAGES)
+            message(STATUS "Installing python packages: ${arg_PACKAGES}")
+            vcpkg_execute_required_process(COMMAND "${${arg_OUT_PYTHON_VAR}}" -I -m pip install ${arg_PACKAGES}
+                                           WORKING_DIRECTORY "${CURRENT_BUILDTREES_DIR}"
+                                           LOGNAME "pip-install-packages-${TARGET_TRIPLET}")
         endif()
-        set(python_venv_options --symlinks)
+        file(WRITE "${venv_stamp}" "python: ${arg_PYTHON_EXECUTABLE}\nrequirements: ${arg_REQUIREMENTS_FILE}\npackages: ${arg_PACKAGES}\n")
+    endif()
+    if(NOT X_VCPKG_PYTHON_VENV_NO_CACHE)
+        file(LOCK "${venv_path}.lock" RELEASE)
     endif()
 
-    set(ENV{PYTHONNOUSERSITE} "1")
-    message(STATUS "Setting up python virtual environment...")
-    vcpkg_execute_required_process(COMMAND "${arg_PYTHON_EXECUTABLE}" -I -m "${python_venv}" ${python_venv_options} "${venv_path}"
-                                   WORKING_DIRECTORY "${CURRENT_BUILDTREES_DIR}"
-                                   LOGNAME "venv-setup-${TARGET_TRIPLET}")
     vcpkg_add_to_path(PREPEND "${venv_path}${python_sub_path}")
-    set(${arg_OUT_PYTHON_VAR} "${venv_path}${python_sub_path}/python${VCPKG_HOST_EXECUTABLE_SUFFIX}")
     set(ENV{VIRTUAL_ENV} "${venv_path}")
     unset(ENV{PYTHONHOME})
     unset(ENV{PYTHONPATH})
-    if(DEFINED arg_REQUIREMENTS_FILE)
-        message(STATUS "Installing requirements from: ${arg_REQUIREMENTS_FILE}")
-        vcpkg_execute_required_process(COMMAND "${${arg_OUT_PYTHON_VAR}}" -I -m pip install -r ${arg_REQUIREMENTS_FILE}
-                                       WORKING_DIRECTORY "${CURRENT_BUILDTREES_DIR}"
-                                       LOGNAME "pip-install-requirements-file-${TARGET_TRIPLET}")
-    endif()
-    if(DEFINED arg_PACKAGES)
-        message(STATUS "Installing python packages: ${arg_PACKAGES}")
-        vcpkg_execute_required_process(COMMAND "${${arg_OUT_PYTHON_VAR}}" -I -m pip install ${arg_PACKAGES}
-                                       WORKING_DIRECTORY "${CURRENT_BUILDTREES_DIR}"
-                                       LOGNAME "pip-install-packages-${TARGET_TRIPLET}")
-    endif()
     message(STATUS "Setting up python virtual environment... finished.")
     set(${arg_OUT_PYTHON_VAR} "${${arg_OUT_PYTHON_VAR}}" PARENT_SCOPE)
     set(${arg_OUT_PYTHON_VAR} "${${arg_OUT_PYTHON_VAR}}" CACHE PATH "" FORCE)
@@ -5,10 +5,22 @@ function(vcpkg_make_install)
     cmake_parse_arguments(PARSE_ARGV 0 arg
         "DISABLE_PARALLEL"
         "LOGFILE_ROOT;MAKEFILE"
-        "OPTIONS;OPTIONS_DEBUG;OPTIONS_RELEASE;TARGETS"
+        "OPTIONS;OPTIONS_DEBUG;OPTIONS_RELEASE;TARGETS;SERIAL_TARGETS"
     )
     z_vcpkg_unparsed_args(FATAL_ERROR)
 
+    if(COMMAND z_vcpkg_adaptive_concurrency)
+        z_vcpkg_adaptive_concurrency(vcpkg_make_install)
+    endif()
+
+    # VCPKG_AUDIT_DISABLE_PARALLEL builds serialized targets with parallelism and without the
+    # serial fallback or retries, and records the outcome in parallel-audit-<triplet>.log.
+    set(audit_parallel OFF)
+    if((arg_DISABLE_PARALLEL OR DEFINED arg_SERIAL_TARGETS) AND VCPKG_AUDIT_DISABLE_PARALLEL)
+        message(STATUS "Auditing DISABLE_PARALLEL/SERIAL_TARGETS: building with parallelism enabled")
+        set(audit_parallel ON)
+    endif()
+
     if(NOT DEFINED arg_LOGFILE_ROOT)
         set(arg_LOGFILE_ROOT "make")
     endif()
@@ -99,7 +111,23 @@ function(vcpkg_make_install)
             vcpkg_list(SET make_cmd_line ${make_command} ${arg_OPTIONS} ${arg_OPTIONS_${cmake_buildtype}} V=1 -j ${VCPKG_CONCURRENCY} ${trace_opts} -f ${arg_MAKEFILE} ${target} ${destdir_opt})
             vcpkg_list(SET no_parallel_make_cmd_line ${make_command} ${arg_OPTIONS} ${arg_OPTIONS_${cmake_buildtype}} V=1 -j 1 ${trace_opts} -f ${arg_MAKEFILE} ${target} ${destdir_opt})
             message(STATUS "Making target '${target}' for ${TARGET_TRIPLET}-${short_buildtype}")
-            if (arg_DISABLE_PARALLEL)
+            set(serial_target OFF)
+            if(arg_DISABLE_PARALLEL OR target IN_LIST arg_SERIAL_TARGETS)
+                set(serial_target ON)
+            endif()
+            set(audit_log "${CURRENT_BUILDTREES_DIR}/parallel-audit-${TARGET_TRIPLET}.log")
+            if(serial_target AND audit_parallel)
+                file(APPEND "${audit_log}" "vcpkg_make_install ${arg_LOGFILE_ROOT}-${target_no_slash}-${TARGET_TRIPLET}-${short_buildtype}: started\n")
+                set(Z_VCPKG_EXECUTE_BUILD_PROCESS_NO_RETRY ON)
+                vcpkg_run_shell_as_build(
+                    WORKING_DIRECTORY "${working_directory}"
+                    LOGNAME "${arg_LOGFILE_ROOT}-${target_no_slash}-${TARGET_TRIPLET}-${short_buildtype}"
+                    SHELL ${shell_cmd}
+                    COMMAND ${configure_env} ${make_cmd_line}
+                )
+                file(APPEND "${audit_log}" "vcpkg_make_install ${arg_LOGFILE_ROOT}-${target_no_slash}-${TARGET_TRIPLET}-${short_buildtype}: passed\n")
+                unset(Z_VCPKG_EXECUTE_BUILD_PROCESS_NO_RETRY)
+            elseif(serial_target)
                 vcpkg_run_shell_as_build(
                     WORKING_DIRECTORY "${working_directory}"
                     LOGNAME "${arg_LOGFILE_ROOT}-${target_no_slash}-${TARGET_TRIPLET}-${short_buildtype}"
@@ -115,8 +143,15 @@ function(vcpkg_make_install)
                     NO_PARALLEL_COMMAND ${configure_env} ${no_parallel_make_cmd_line}
                 )
             endif()
-            file(READ "${CURRENT_BUILDTREES_DIR}/${arg_LOGFILE_ROOT}-${target_no_slash}-${TARGET_TRIPLET}-${short_buildtype}-out.log" logdata) 
-            if(logdata MATCHES "Warning: linker path does not have real file for library")
+            set(logfile "${CURRENT_BUILDTREES_DIR}/${arg_LOGFILE_ROOT}-${target_no_slash}-${TARGET_TRIPLET}-${short_buildtype}-out.log")
+            set(libtool_warning "Warning: linker path does not have real file for library")
+            if(COMMAND z_vcpkg_execute_build_process_match_logs)
+                # Scans the log in chunks instead of reading it at once
+                z_vcpkg_execute_build_process_match_logs(logdata "${libtool_warning}" "${logfile}")
+            else()
+                file(READ "${logfile}" logdata)
+            endif()
+            if(logdata MATCHES "${libtool_warning}")
                 message(FATAL_ERROR "libtool could not find a file being linked against!")
             endif()
         endforeach()
@@ -124,6 +159,10 @@ function(vcpkg_make_install)
         z_vcpkg_make_restore_env()
 
         vcpkg_restore_env_variables(VARS LIB LIBPATH LIBRARY_PATH)
+
+        if("install" IN_LIST arg_TARGETS AND COMMAND z_vcpkg_buildtree_reclaim)
+            z_vcpkg_buildtree_reclaim("${working_directory}" "${TARGET_TRIPLET}-${short_buildtype}")
+        endif()
     endforeach()
 
     ## TODO: Fix DESTDIR handling
@@ -7,6 +7,10 @@ function(vcpkg_msbuild_install)
         "OPTIONS;OPTIONS_RELEASE;OPTIONS_DEBUG;DEPENDENT_PKGCONFIG;ADDITIONAL_LIBS;ADDITIONAL_LIBS_DEBUG;ADDITIONAL_LIBS_RELEASE"
     )
 
+    if(COMMAND z_vcpkg_adaptive_concurrency)
+        z_vcpkg_adaptive_concurrency(vcpkg_msbuild_install)
+    endif()
+
     if(VCPKG_CROSSCOMPILING)
         set(arg_ADD_BIN_TO_PATH OFF)
     endif()
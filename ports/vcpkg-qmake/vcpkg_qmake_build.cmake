@@ -18,6 +18,10 @@ function(vcpkg_qmake_build)
         "TARGETS;RELEASE_TARGETS;DEBUG_TARGETS"
     )
 
+    if(COMMAND z_vcpkg_adaptive_concurrency)
+        z_vcpkg_adaptive_concurrency(vcpkg_qmake_build)
+    endif()
+
     # Make sure that the linker finds the libraries used
     vcpkg_backup_env_variables(VARS PATH LD_LIBRARY_PATH)
 
@@ -1,7 +1,15 @@
 function(vcpkg_install_meson)
     cmake_parse_arguments(PARSE_ARGV 0 arg "ADD_BIN_TO_PATH" "" "")
 
+    if(COMMAND z_vcpkg_adaptive_concurrency)
+        z_vcpkg_adaptive_concurrency(vcpkg_install_meson)
+    endif()
+
     vcpkg_find_acquire_program(NINJA)
+    set(parallel_param "")
+    if(Z_VCPKG_ADAPTIVE_CONCURRENCY)
+        set(parallel_param "-j${VCPKG_CONCURRENCY}")
+    endif()
     unset(ENV{DESTDIR}) # installation directory was already specified with '--prefix' option
 
     if(VCPKG_TARGET_IS_OSX)
@@ -31,7 +39,7 @@ function(vcpkg_install_meson)
             endif()
         endif()
         vcpkg_execute_required_process(
-            COMMAND "${NINJA}" install -v
+            COMMAND "${NINJA}" install -v ${parallel_param}
             WORKING_DIRECTORY "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${short_buildtype}"
             LOGNAME package-${TARGET_TRIPLET}-${short_buildtype}
         )
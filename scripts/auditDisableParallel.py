@@ -0,0 +1,95 @@
+import os
+import re
+import sys
+import argparse
+
+from pathlib import Path
+
+
+SCRIPT_DIRECTORY = os.path.dirname(os.path.abspath(__file__))
+PORTS_DIRECTORY = os.path.join(SCRIPT_DIRECTORY, '../ports')
+TRIPLETS_DIRECTORY = os.path.join(SCRIPT_DIRECTORY, '../triplets')
+
+# DISABLE_PARALLEL as passed to any build helper. Only vcpkg_cmake_build/vcpkg_cmake_install and
+# vcpkg_make_install are audited; the legacy helpers write no audit log, so ports which only use them
+# are listed but never reported. DISABLE_PARALLEL_CONFIGURE only affects configure and is not audited.
+DISABLE_PARALLEL_REGEX = re.compile(r'\b(DISABLE_PARALLEL(_INSTALL)?|SERIAL_TARGETS)\b')
+
+
+def find_serialized_ports():
+    port_names = []
+    for port_name in sorted(os.listdir(PORTS_DIRECTORY)):
+        portfile_path = os.path.join(PORTS_DIRECTORY, port_name, 'portfile.cmake')
+        if not os.path.exists(portfile_path):
+            continue
+        with open(portfile_path, 'r', encoding='utf-8', errors='replace') as portfile:
+            if DISABLE_PARALLEL_REGEX.search(portfile.read()):
+                port_names.append(port_name)
+    return port_names
+
+
+def write_audit_triplet(triplet, output_directory):
+    triplet_path = None
+    for root, _, files in os.walk(TRIPLETS_DIRECTORY):
+        if f'{triplet}.cmake' in files:
+            triplet_path = os.path.join(root, f'{triplet}.cmake')
+            break
+    if not triplet_path:
+        print(f'Error: Unknown triplet {triplet}', file=sys.stderr)
+        sys.exit(1)
+
+    os.makedirs(output_directory, exist_ok=True)
+    audit_triplet_path = os.path.join(output_directory, f'{triplet}.cmake')
+    with open(audit_triplet_path, 'w') as audit_triplet:
+        audit_triplet.write(f'include("{Path(triplet_path).resolve().as_posix()}")\n')
+        audit_triplet.write('set(VCPKG_AUDIT_DISABLE_PARALLEL ON)\n')
+    return audit_triplet_path
+
+
+def collect_audit_results(buildtrees_directory):
+    # Each audited step writes "started" before and "passed" after the parallel build.
+    results = {}
+    for log_path in Path(buildtrees_directory).glob('*/parallel-audit-*.log'):
+        port_name = log_path.parent.name
+        steps = {}
+        for line in log_path.read_text().splitlines():
+            step, _, state = line.rpartition(': ')
+            steps[step] = state
+        results[port_name] = steps
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Audit ports which disable parallel builds by rebuilding them with parallelism enabled.')
+    subparsers = parser.add_subparsers(dest='command', required=True)
+    subparsers.add_parser('list', help='List ports which serialize build or install steps.')
+    triplet_parser = subparsers.add_parser(
+        'triplet', help='Write an overlay triplet which enables VCPKG_AUDIT_DISABLE_PARALLEL.')
+    triplet_parser.add_argument('triplet')
+    triplet_parser.add_argument('--output', default='audit-triplets')
+    report_parser = subparsers.add_parser(
+        'report', help='Summarize parallel-audit logs after building the listed ports with the overlay triplet.')
+    report_parser.add_argument('buildtrees', nargs='?', default=os.path.join(SCRIPT_DIRECTORY, '../buildtrees'))
+    args = parser.parse_args()
+
+    if args.command == 'list':
+        for port_name in find_serialized_ports():
+            print(port_name)
+    elif args.command == 'triplet':
+        audit_triplet_path = write_audit_triplet(args.triplet, args.output)
+        print(f'Wrote {audit_triplet_path}')
+        print(f'Run: vcpkg install --overlay-triplets={args.output} --triplet={args.triplet} --no-binarycaching <ports>')
+    elif args.command == 'report':
+        results = collect_audit_results(args.buildtrees)
+        for port_name in sorted(results):
+            steps = results[port_name]
+            failed = [step for step, state in steps.items() if state != 'passed']
+            if failed:
+                print(f'{port_name}: parallel build failed in {", ".join(failed)}')
+            else:
+                print(f'{port_name}: parallel build passed ({len(steps)} steps), DISABLE_PARALLEL may be removed')
+
+
+if __name__ == "__main__":
+    main()
@@ -1,48 +1,62 @@
 #!/usr/bin/env node
 import * as fs from "fs";
 import * as path from "path";
-
-const include_subpath = "/include/";
+import { OwnersIndex, indexFileName } from "./owners_index.js";
 
 function getFiles(dirPath: string): string[] {
   const files = fs.readdirSync(dirPath);
   return files.filter((f) => !f.startsWith("."));
 }
 
-function genAllFileStrings(
-  dirPath: string,
-  files: string[],
-  headersStream: fs.WriteStream,
-  outputStream: fs.WriteStream
-) {
+function readListFile(filePath: string): string[] {
+  const files: string[] = [];
+  const content = fs.readFileSync(filePath, "utf8");
+  const lines = content.split(/\r?\n/);
+  for (const raw of lines) {
+    if (!raw) continue;
+    const line = raw.trim();
+    if (line.length === 0) continue;
+    if (line.endsWith("/")) continue;
+    // Remove the leading triplet directory
+    const idx = line.indexOf("/");
+    files.push(idx >= 0 ? line.substring(idx) : line);
+  }
+  return files;
+}
+
+// Reads only the .list files which changed since the index was written, and drops the packages
+// whose .list file is gone.
+function updateIndex(dirPath: string, files: string[], index: OwnersIndex): number {
+  const seen = new Set<string>();
+  let read = 0;
   for (const file of files) {
     const components = file.split("_");
     const pkg = components[0] + ":" + components[2].replace(".list", "");
-    const content = fs.readFileSync(path.join(dirPath, file), "utf8");
-    const lines = content.split(/\r?\n/);
-    for (const raw of lines) {
-      if (!raw) continue;
-      const line = raw.trim();
-      if (line.length === 0) continue;
-      if (line.endsWith("/")) continue;
-      // Remove the leading triplet directory
-      const idx = line.indexOf("/");
-      const filepath = idx >= 0 ? line.substring(idx) : line;
-      outputStream.write(pkg + ":" + filepath + "\n");
-      if (filepath.startsWith(include_subpath)) {
-        headersStream.write(pkg + ":" + filepath.substring(include_subpath.length) + "\n");
-      }
+    const filePath = path.join(dirPath, file);
+    const stat = fs.statSync(filePath);
+    const stamp = `${stat.mtimeMs}:${stat.size}`;
+    seen.add(pkg);
+    if (index.stamp(pkg) === stamp) continue;
+    index.set(pkg, stamp, readListFile(filePath));
+    read++;
+  }
+  for (const pkg of index.packageNames()) {
+    if (!seen.has(pkg)) {
+      index.delete(pkg);
     }
   }
+  return read;
 }
 
 function usage() {
-  console.error("Usage: file_script.ts --info-dir <path-to-info-dir> [--out-dir <path>]");
+  console.error("Usage: file_script.ts --info-dir <path-to-info-dir> [--out-dir <path>] [--index <path>] [--full]");
 }
 
 function parseArgs(argv: string[]) {
   let infoDir: string | undefined;
   let outDir = "scripts/list_files";
+  let indexPath: string | undefined;
+  let full = false;
   for (let i = 0; i < argv.length; i++) {
     const a = argv[i];
     if (a === "--info-dir") {
@@ -51,6 +65,11 @@ function parseArgs(argv: string[]) {
     } else if (a === "--out-dir") {
       i++;
       outDir = argv[i];
+    } else if (a === "--index") {
+      i++;
+      indexPath = argv[i];
+    } else if (a === "--full") {
+      full = true;
     } else if (a.startsWith("--")) {
       console.error(`Unknown argument: ${a}`);
       usage();
@@ -66,28 +85,17 @@ function parseArgs(argv: string[]) {
     usage();
     process.exit(2);
   }
-  return { infoDir, outDir };
+  return { infoDir, outDir, indexPath: indexPath ?? path.join(outDir, indexFileName), full };
 }
 
 function main() {
-  const { infoDir: dir, outDir } = parseArgs(process.argv.slice(2));
-  try {
-    fs.mkdirSync(outDir, { recursive: true });
-  } catch {
-    // ignore
-  }
-
-  const headersPath = path.join(outDir, "VCPKGHeadersDatabase.txt");
-  const dbPath = path.join(outDir, "VCPKGDatabase.txt");
-  const headers = fs.createWriteStream(headersPath, { encoding: "utf8" });
-  const output = fs.createWriteStream(dbPath, { encoding: "utf8" });
-  try {
-    const files = getFiles(dir);
-    genAllFileStrings(dir, files, headers, output);
-  } finally {
-    headers.end();
-    output.end();
-  }
+  const { infoDir: dir, outDir, indexPath, full } = parseArgs(process.argv.slice(2));
+  const index = full ? new OwnersIndex() : OwnersIndex.load(indexPath);
+  const files = getFiles(dir);
+  const read = updateIndex(dir, files, index);
+  index.save(indexPath);
+  index.writeDatabases(outDir);
+  console.log(`Read ${read} of ${files.length} .list files; wrote ${indexPath}`);
 }
 
 main();
@@ -2,48 +2,29 @@
 import * as fs from "fs";
 import * as path from "path";
 import * as https from "https";
-import AdmZip from "adm-zip";
+import * as os from "os";
+import { pipeline } from "stream/promises";
 import { execSync } from "child_process";
+import { OwnersIndex, indexFileName, listZipEntries, packageFilesFromZipEntries } from "./owners_index.js";
 
-const keyword = "/include/";
-
-function writeOutputLines(outDir: string, dbLines: string[], headerLines: string[]) {
-  fs.mkdirSync(outDir, { recursive: true });
-  fs.writeFileSync(path.join(outDir, "VCPKGDatabase.txt"), dbLines.join("\n") + (dbLines.length ? "\n" : ""));
-  fs.writeFileSync(path.join(outDir, "VCPKGHeadersDatabase.txt"), headerLines.join("\n") + (headerLines.length ? "\n" : ""));
-}
-
-function listZipFiles(buffer: Buffer, pkgName: string, dbLines: string[], headerLines: string[]) {
-  const zip = new AdmZip(buffer);
-  const entries = zip.getEntries();
-  for (const e of entries) {
-    if (e.isDirectory) continue;
-    const entryName = "/" + e.entryName.replace(/\\/g, "/");
-    if (entryName === "/BUILD_INFO" || entryName === "/CONTROL") continue;
-    dbLines.push(`${pkgName}:${entryName}`);
-    if (entryName.startsWith(keyword)) {
-      headerLines.push(`${pkgName}:${entryName.substring(keyword.length)}`);
-    }
-  }
-}
-
-function downloadUrlToBuffer(url: string): Promise<Buffer> {
+// Streams a download to a file; packages can be gigabytes, so they are never held in memory.
+function downloadUrlToFile(url: string, filePath: string): Promise<void> {
   return new Promise((resolve, reject) => {
     https.get(url, (res) => {
       if (res.statusCode && res.statusCode >= 400) {
+        res.resume();
         reject(new Error(`HTTP ${res.statusCode} while fetching ${url}`));
         return;
       }
-      const chunks: Buffer[] = [];
-      res.on("data", (c) => chunks.push(c));
-      res.on("end", () => resolve(Buffer.concat(chunks)));
+      pipeline(res, fs.createWriteStream(filePath)).then(resolve, reject);
     }).on("error", reject);
   });
 }
 
 function usage() {
-  console.error("Usage: file_script_from_cache.ts --pr-hashes <pr-hashes.json> --blob-base-url <blob-base-url> [--target-branch <branch>] [--out-dir <path>]");
+  console.error("Usage: file_script_from_cache.ts --pr-hashes <pr-hashes.json> (--blob-base-url <blob-base-url> | --zip-dir <path>) [--target-branch <branch>] [--out-dir <path>] [--index <path>]");
   console.error("blob-base-url should include SAS token (e.g. https://<account>.blob.core.windows.net/<container>/?<sas>)");
+  console.error("zip-dir is a local directory with the <sha>.zip packages, for example a files binary cache");
 }
 
 function parseArgs(argv: string[]) {
@@ -51,8 +32,10 @@ function parseArgs(argv: string[]) {
   // legacy: positional: <pr-hashes> <blob-base-url> [target-branch]
   let prHashesPath: string | undefined;
   let blobBaseUrl: string | undefined;
+  let zipDir: string | undefined;
   let targetBranch = "master";
   let outDir = "scripts/list_files";
+  let indexPath: string | undefined;
   for (let i = 0; i < argv.length; i++) {
     const a = argv[i];
     if (a === "--pr-hashes") {
@@ -61,19 +44,25 @@ function parseArgs(argv: string[]) {
     } else if (a === "--blob-base-url") {
       i++;
       blobBaseUrl = argv[i];
+    } else if (a === "--zip-dir") {
+      i++;
+      zipDir = argv[i];
     } else if (a === "--target-branch") {
       i++;
       targetBranch = argv[i];
     } else if (a === "--out-dir") {
       i++;
       outDir = argv[i];
+    } else if (a === "--index") {
+      i++;
+      indexPath = argv[i];
     } else if (a.startsWith("--")) {
       console.error(`Unknown argument: ${a}`);
       usage();
       process.exit(2);
     } else if (!prHashesPath) {
       prHashesPath = a;
-    } else if (!blobBaseUrl) {
+    } else if (!blobBaseUrl && !zipDir) {
       blobBaseUrl = a.replace(/[\/\\]+$/g, "");
     } else if (targetBranch === "master") {
       targetBranch = a;
@@ -83,15 +72,15 @@ function parseArgs(argv: string[]) {
       process.exit(2);
     }
   }
-  if (!prHashesPath || !blobBaseUrl) {
+  if (!prHashesPath || !blobBaseUrl === !zipDir) {
     usage();
     process.exit(2);
   }
-  return { prHashesPath, blobBaseUrl, targetBranch, outDir };
+  return { prHashesPath, blobBaseUrl, zipDir, targetBranch, outDir, indexPath: indexPath ?? path.join(outDir, indexFileName) };
 }
 
 async function main() {
-  const { prHashesPath, blobBaseUrl, targetBranch, outDir } = parseArgs(process.argv.slice(2));
+  const { prHashesPath, blobBaseUrl, zipDir, targetBranch, outDir, indexPath } = parseArgs(process.argv.slice(2));
 
   const prHashes = JSON.parse(fs.readFileSync(prHashesPath, "utf8")) as Array<{ name: string; triplet: string; state: string; abi: string }>;
   // Expect vcpkg-tool produced format: array of objects
@@ -103,8 +92,10 @@ async function main() {
     process.exit(2);
   }
 
-  const dbLines: string[] = [];
-  const headerLines: string[] = [];
+  // Packages of unchanged ports stay as they are; changed ones are replaced unless their ABI is already indexed.
+  // The output only lists the packages of this run, like the pr-hashes.json it is made from.
+  const index = OwnersIndex.load(indexPath);
+  const processed = new Set<string>();
 
   // Determine list of ports to process from git-diff (only folders under ports/ that changed)
   let changedPorts: string[] = [];
@@ -133,7 +124,8 @@ async function main() {
     changedPorts = Array.from(set);
     if (changedPorts.length === 0) {
       console.log(`git diff found no changed ports under ports/ for range ${mergebase}...HEAD; exiting.`);
-      writeOutputLines(outDir, dbLines, headerLines);
+      index.save(indexPath);
+      index.writeDatabases(outDir, processed);
       return;
     }
   } catch (e) {
@@ -150,12 +142,29 @@ async function main() {
         throw new Error(`Invalid SHA format in pr-hashes.json for port ${port}: ${item.abi}`);
       }
       const abi = item.abi;
+      const pkgName = `${port}:${item.triplet}`;
+      if (index.stamp(pkgName) === abi) {
+        console.log(`${pkgName} ${abi} is already indexed`);
+        processed.add(pkgName);
+        continue;
+      }
+      if (zipDir) {
+        try {
+          index.set(pkgName, abi, packageFilesFromZipEntries(listZipEntries(path.join(zipDir, `${abi}.zip`))));
+          processed.add(pkgName);
+        } catch (err) {
+          // The files of an older ABI would be stale
+          console.warn(`Failed to process package for ${port}: ${err}`);
+          index.delete(pkgName);
+        }
+        continue;
+      }
       // blob named <sha>.zip
       // Ensure we append the ABI path before the SAS query string, i.e.:
       // https://.../<container>/<sha>.zip?<sas>
       let blobUrl: string;
       try {
-        const u = new URL(blobBaseUrl);
+        const u = new URL(blobBaseUrl!);
         const sas = u.search; // includes leading '?' or empty
         // build base path without query and without trailing slash
         const baseNoQuery = `${u.origin}${u.pathname.replace(/[\/\\]+$/g, "")}`;
@@ -165,16 +174,22 @@ async function main() {
         process.exit(2);
       }
       console.log(`Downloading ${blobUrl} for port ${port}...`);
+      const zipPath = path.join(os.tmpdir(), `owners-db-${abi}.zip`);
       try {
-        const buf = await downloadUrlToBuffer(blobUrl);
-        listZipFiles(buf, `${port}:${item.triplet}`, dbLines, headerLines);
+        await downloadUrlToFile(blobUrl, zipPath);
+        index.set(pkgName, abi, packageFilesFromZipEntries(listZipEntries(zipPath)));
+        processed.add(pkgName);
       } catch (err) {
         console.warn(`Failed to download or process blob for ${port}: ${err}`);
+        index.delete(pkgName);
+      } finally {
+        fs.rmSync(zipPath, { force: true });
       }
     }
   }
 
-  writeOutputLines(outDir, dbLines, headerLines);
+  index.save(indexPath);
+  index.writeDatabases(outDir, processed);
   console.log(`Wrote ${path.join(outDir, "VCPKGDatabase.txt")} and ${path.join(outDir, "VCPKGHeadersDatabase.txt")}`);
 }
 
@@ -0,0 +1,270 @@
+import * as fs from "fs";
+import * as path from "path";
+
+export const includeSubpath = "/include/";
+export const indexFileName = "VCPKGOwnersIndex.json";
+const indexFormat = 1;
+
+// Files of one installed package, and what they were read from: the ABI of a binary package,
+// or the mtime and size of an info .list file.
+export interface PackageFiles {
+  stamp: string;
+  files: string[];
+}
+
+// A table of paths sorted by UTF-16 code units, with the index of the owning package for each path.
+// Lookups are binary searches; entries for the same path are adjacent.
+interface PathTable {
+  paths: string[];
+  owners: number[];
+}
+
+function compare(a: string, b: string): number {
+  return a < b ? -1 : a > b ? 1 : 0;
+}
+
+function lowerBound(paths: string[], key: string): number {
+  let low = 0;
+  let high = paths.length;
+  while (low < high) {
+    const middle = (low + high) >>> 1;
+    if (paths[middle] < key) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+function buildTable(packageIds: string[], packages: Map<string, PackageFiles>, header: boolean): PathTable {
+  const entries: Array<[string, number]> = [];
+  packageIds.forEach((id, owner) => {
+    for (const file of packages.get(id)!.files) {
+      if (!header) {
+        entries.push([file, owner]);
+      } else if (file.startsWith(includeSubpath)) {
+        entries.push([file.substring(includeSubpath.length), owner]);
+      }
+    }
+  });
+  entries.sort((a, b) => compare(a[0], b[0]) || a[1] - b[1]);
+  return { paths: entries.map((e) => e[0]), owners: entries.map((e) => e[1]) };
+}
+
+// File ownership of installed packages, updated package by package. The sorted path tables are
+// rebuilt when the index is saved, so loading an index and answering queries never sorts. The
+// per-package file lists are only recovered from the tables once the index is modified.
+export class OwnersIndex {
+  private packages = new Map<string, PackageFiles>();
+  private materialized = true;
+  private packageIds: string[] = [];
+  private files: PathTable = { paths: [], owners: [] };
+  private headers: PathTable = { paths: [], owners: [] };
+  private dirty = false;
+
+  static load(indexPath: string): OwnersIndex {
+    const index = new OwnersIndex();
+    if (!fs.existsSync(indexPath)) {
+      return index;
+    }
+    const data = JSON.parse(fs.readFileSync(indexPath, "utf8"));
+    if (data.format !== indexFormat) {
+      console.warn(`Ignoring ${indexPath}: format ${data.format} is not ${indexFormat}`);
+      return index;
+    }
+    index.packageIds = data.packages;
+    data.packages.forEach((id: string, i: number) => {
+      index.packages.set(id, { stamp: data.stamps[i], files: [] });
+    });
+    index.files = data.files;
+    index.headers = data.headers;
+    index.materialized = false;
+    return index;
+  }
+
+  private materialize() {
+    if (this.materialized) {
+      return;
+    }
+    for (let i = 0; i < this.files.paths.length; i++) {
+      this.packages.get(this.packageIds[this.files.owners[i]])!.files.push(this.files.paths[i]);
+    }
+    this.materialized = true;
+  }
+
+  packageNames(): string[] {
+    return Array.from(this.packages.keys());
+  }
+
+  stamp(packageId: string): string | undefined {
+    return this.packages.get(packageId)?.stamp;
+  }
+
+  set(packageId: string, stamp: string, files: string[]) {
+    this.materialize();
+    this.packages.set(packageId, { stamp, files: files.slice().sort(compare) });
+    this.dirty = true;
+  }
+
+  delete(packageId: string) {
+    this.materialize();
+    if (this.packages.delete(packageId)) {
+      this.dirty = true;
+    }
+  }
+
+  private update() {
+    if (!this.dirty) {
+      return;
+    }
+    this.packageIds = Array.from(this.packages.keys()).sort(compare);
+    this.files = buildTable(this.packageIds, this.packages, false);
+    this.headers = buildTable(this.packageIds, this.packages, true);
+    this.dirty = false;
+  }
+
+  save(indexPath: string) {
+    this.update();
+    const data = {
+      format: indexFormat,
+      packages: this.packageIds,
+      stamps: this.packageIds.map((id) => this.packages.get(id)!.stamp),
+      files: this.files,
+      headers: this.headers,
+    };
+    fs.mkdirSync(path.dirname(indexPath), { recursive: true });
+    fs.writeFileSync(indexPath, JSON.stringify(data));
+  }
+
+  // Writes VCPKGDatabase.txt and VCPKGHeadersDatabase.txt, grouped by package and sorted by path.
+  // With `only`, the other packages of the index are left out.
+  writeDatabases(outDir: string, only?: Set<string>) {
+    this.update();
+    this.materialize();
+    fs.mkdirSync(outDir, { recursive: true });
+    const dbLines: string[] = [];
+    const headerLines: string[] = [];
+    for (const id of this.packageIds) {
+      if (only && !only.has(id)) continue;
+      for (const file of this.packages.get(id)!.files) {
+        dbLines.push(`${id}:${file}`);
+        if (file.startsWith(includeSubpath)) {
+          headerLines.push(`${id}:${file.substring(includeSubpath.length)}`);
+        }
+      }
+    }
+    fs.writeFileSync(path.join(outDir, "VCPKGDatabase.txt"), dbLines.join("\n") + (dbLines.length ? "\n" : ""));
+    fs.writeFileSync(path.join(outDir, "VCPKGHeadersDatabase.txt"), headerLines.join("\n") + (headerLines.length ? "\n" : ""));
+  }
+
+  private find(table: PathTable, key: string, prefix: boolean): Array<[string, string]> {
+    this.update();
+    const result: Array<[string, string]> = [];
+    for (let i = lowerBound(table.paths, key); i < table.paths.length; i++) {
+      const found = table.paths[i];
+      if (prefix ? !found.startsWith(key) : found !== key) {
+        break;
+      }
+      result.push([this.packageIds[table.owners[i]], found]);
+    }
+    return result;
+  }
+
+  // Packages which install a file, e.g. "/include/zlib.h".
+  ownersOfFile(file: string): string[] {
+    return this.find(this.files, file, false).map((e) => e[0]);
+  }
+
+  // Packages which install a header as it is included, e.g. "zlib.h" or "boost/asio.hpp".
+  ownersOfHeader(header: string): string[] {
+    return this.find(this.headers, header, false).map((e) => e[0]);
+  }
+
+  // [package, header] of all headers below a directory or with a name prefix, e.g. "boost/asio/".
+  headersWithPrefix(prefix: string): Array<[string, string]> {
+    return this.find(this.headers, prefix, true);
+  }
+}
+
+// Zip records, see APPNOTE.TXT sections 4.3.12 to 4.3.16.
+const endOfCentralDirectorySignature = 0x06054b50;
+const zip64EndOfCentralDirectorySignature = 0x06064b50;
+const zip64LocatorSignature = 0x07064b50;
+const centralDirectoryHeaderSignature = 0x02014b50;
+const maxCommentLength = 0xffff;
+
+function readAt(fd: number, position: number, length: number): Buffer {
+  const buffer = Buffer.alloc(length);
+  let read = 0;
+  while (read < length) {
+    const n = fs.readSync(fd, buffer, read, length - read, position + read);
+    if (n === 0) {
+      throw new Error(`Unexpected end of file at ${position + read}`);
+    }
+    read += n;
+  }
+  return buffer;
+}
+
+// Lists the entry names of a zip file from its central directory. Only the tail of the file and the
+// central directory are read, never the compressed contents.
+export function listZipEntries(zipPath: string): string[] {
+  const fd = fs.openSync(zipPath, "r");
+  try {
+    const size = fs.fstatSync(fd).size;
+    const tailLength = Math.min(size, 22 + maxCommentLength + 20);
+    const tail = readAt(fd, size - tailLength, tailLength);
+    let eocd = -1;
+    for (let i = tailLength - 22; i >= 0; i--) {
+      if (tail.readUInt32LE(i) === endOfCentralDirectorySignature) {
+        eocd = i;
+        break;
+      }
+    }
+    if (eocd < 0) {
+      throw new Error(`${zipPath} is not a zip file`);
+    }
+    let entryCount = tail.readUInt16LE(eocd + 10);
+    let directorySize = tail.readUInt32LE(eocd + 12);
+    let directoryOffset = tail.readUInt32LE(eocd + 16);
+    if (eocd >= 20 && tail.readUInt32LE(eocd - 20) === zip64LocatorSignature) {
+      const zip64Offset = Number(tail.readBigUInt64LE(eocd - 20 + 8));
+      const zip64 = readAt(fd, zip64Offset, 56);
+      if (zip64.readUInt32LE(0) !== zip64EndOfCentralDirectorySignature) {
+        throw new Error(`${zipPath} has an invalid zip64 end of central directory`);
+      }
+      entryCount = Number(zip64.readBigUInt64LE(32));
+      directorySize = Number(zip64.readBigUInt64LE(40));
+      directoryOffset = Number(zip64.readBigUInt64LE(48));
+    }
+    const directory = readAt(fd, directoryOffset, directorySize);
+    const names: string[] = [];
+    let offset = 0;
+    for (let i = 0; i < entryCount; i++) {
+      if (directory.readUInt32LE(offset) !== centralDirectoryHeaderSignature) {
+        throw new Error(`${zipPath} has an invalid central directory entry at ${directoryOffset + offset}`);
+      }
+      const nameLength = directory.readUInt16LE(offset + 28);
+      const extraLength = directory.readUInt16LE(offset + 30);
+      const commentLength = directory.readUInt16LE(offset + 32);
+      names.push(directory.toString("utf8", offset + 46, offset + 46 + nameLength));
+      offset += 46 + nameLength + extraLength + commentLength;
+    }
+    return names;
+  } finally {
+    fs.closeSync(fd);
+  }
+}
+
+// The files of a binary package as recorded in the database, e.g. "/include/zlib.h".
+export function packageFilesFromZipEntries(entries: string[]): string[] {
+  const files: string[] = [];
+  for (const name of entries) {
+    if (name.endsWith("/") || name.endsWith("\\")) continue;
+    const entryName = "/" + name.replace(/\\/g, "/");
+    if (entryName === "/BUILD_INFO" || entryName === "/CONTROL") continue;
+    files.push(entryName);
+  }
+  return files;
+}
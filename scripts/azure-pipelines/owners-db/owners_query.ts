@@ -0,0 +1,70 @@
+#!/usr/bin/env node
+import { performance } from "perf_hooks";
+import { OwnersIndex } from "./owners_index.js";
+
+interface Query {
+  kind: "header" | "file" | "prefix";
+  key: string;
+}
+
+function usage() {
+  console.error("Usage: owners_query.ts --index <VCPKGOwnersIndex.json> (--header <header> | --file <path> | --prefix <header-prefix>)... [--benchmark <count>]");
+}
+
+function parseArgs(argv: string[]) {
+  let indexPath: string | undefined;
+  let benchmark = 0;
+  const queries: Query[] = [];
+  for (let i = 0; i < argv.length; i++) {
+    const a = argv[i];
+    if (a === "--index") {
+      i++;
+      indexPath = argv[i];
+    } else if (a === "--header" || a === "--file" || a === "--prefix") {
+      i++;
+      queries.push({ kind: a.substring(2) as Query["kind"], key: argv[i] });
+    } else if (a === "--benchmark") {
+      i++;
+      benchmark = parseInt(argv[i], 10);
+    } else {
+      console.error(`Unexpected argument: ${a}`);
+      usage();
+      process.exit(2);
+    }
+  }
+  if (!indexPath || queries.length === 0) {
+    usage();
+    process.exit(2);
+  }
+  return { indexPath, queries, benchmark };
+}
+
+function run(index: OwnersIndex, query: Query): string[] {
+  if (query.kind === "header") {
+    return index.ownersOfHeader(query.key);
+  } else if (query.kind === "file") {
+    return index.ownersOfFile(query.key);
+  }
+  return index.headersWithPrefix(query.key).map(([pkg, header]) => `${pkg}:${header}`);
+}
+
+function main() {
+  const { indexPath, queries, benchmark } = parseArgs(process.argv.slice(2));
+  const loadStart = performance.now();
+  const index = OwnersIndex.load(indexPath);
+  console.error(`Loaded ${indexPath} in ${(performance.now() - loadStart).toFixed(1)} ms`);
+  for (const query of queries) {
+    for (const line of run(index, query)) {
+      console.log(`${query.key}: ${line}`);
+    }
+  }
+  if (benchmark > 0) {
+    const start = performance.now();
+    for (let i = 0; i < benchmark; i++) {
+      run(index, queries[i % queries.length]);
+    }
+    console.error(`${((performance.now() - start) * 1000 / benchmark).toFixed(2)} us per query`);
+  }
+}
+
+main();
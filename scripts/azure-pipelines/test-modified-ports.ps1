@@ -39,6 +39,17 @@ when using vcpkg to test a prerelease MSVC++ compiler)
 .Parameter KnownFailuresAbiLog
 If present, the path to a file containing a list of known ABI failing ABI hashes, typically generated
 by the `vcpkg x-check-features` command.
+
+.PARAMETER AgentCount
+The number of agents which share the ports to build for this triplet. Each agent builds its part, as planned by
+scripts/ciSchedule.py from the durations in DurationHistory, and excludes the others.
+
+.PARAMETER AgentIndex
+Which part of the ports this agent builds, from 0 to AgentCount - 1.
+
+.PARAMETER DurationHistory
+If present, the path to a file with the measured build durations of ports. It is used to partition the ports
+across agents, and the durations of this run are added to it.
 #>
 
 [CmdletBinding(DefaultParameterSetName="ArchivesRoot")]
@@ -57,9 +68,19 @@ Param(
     $BinarySourceStub = $null,
     [String]$BuildReason = $null,
     [switch]$NoParentHashes = $false,
-    [switch]$AllowUnexpectedPassing = $false
+    [switch]$AllowUnexpectedPassing = $false,
+    [ValidateRange(1, 64)]
+    [int]$AgentCount = 1,
+    [ValidateRange(0, 63)]
+    [int]$AgentIndex = 0,
+    [String]$DurationHistory = $null
 )
 
+if ($AgentIndex -ge $AgentCount) {
+    Write-Error "AgentIndex $AgentIndex must be less than AgentCount $AgentCount"
+    exit 1
+}
+
 function Add-ToolchainToTestCMake {
     # The vcpkg.cmake toolchain file is not part of ABI hashing,
     # but changes must trigger at least some testing.
@@ -131,8 +152,15 @@ if ([string]::IsNullOrWhiteSpace($BinarySourceStub)) {
 
 if ($IsWindows) {
     $vcpkgExe = './vcpkg.exe'
+    $pythonExe = 'python'
 } else {
     $vcpkgExe = './vcpkg'
+    $pythonExe = 'python3'
+}
+
+$historyArgs = @()
+if (-Not [string]::IsNullOrWhiteSpace($DurationHistory)) {
+    $historyArgs = @('--history', $DurationHistory)
 }
 
 if ($Triplet -eq 'x64-windows-release') {
@@ -236,6 +264,28 @@ if (($BuildReason -eq 'PullRequest') -and -not $NoParentHashes)
     }
 }
 
+$excludeArgs = @()
+if ($AgentCount -gt 1)
+{
+    if ($BuildReason -eq 'PullRequest') {
+        $changeArgs = @('--since', 'HEAD~1')
+    } else {
+        $changeArgs = @('--all')
+    }
+
+    # vcpkg reads the excluded ports from this response file
+    $excludeFile = Join-Path $WorkingRoot "exclude-$Triplet-$AgentIndex.txt"
+    & $pythonExe "$PSScriptRoot/../ciSchedule.py" @historyArgs plan @changeArgs --triplet $Triplet --agent-count $AgentCount --agent-index $AgentIndex --exclude-file $excludeFile
+    $lastLastExitCode = $LASTEXITCODE
+    if ($lastLastExitCode -ne 0)
+    {
+        Write-Error "Partitioning the ports across $AgentCount agents failed"
+        exit $lastLastExitCode
+    }
+
+    $excludeArgs = @("@$excludeFile")
+}
+
 $allowUnexpectedPassingArgs = @()
 if ($AllowUnexpectedPassing) {
     $allowUnexpectedPassingArgs = @('--allow-unexpected-passing')
@@ -256,8 +306,12 @@ $prHashesFile = Join-Path $ArtifactStagingDirectory "pr-hashes.json"
     @parentHashesArgs `
     @skipFailuresArgs `
     @knownFailuresFromArgs `
+    @excludeArgs `
     @allowUnexpectedPassingArgs
 $lastLastExitCode = $LASTEXITCODE
+if ((-Not [string]::IsNullOrWhiteSpace($DurationHistory)) -and (Test-Path $xunitFile)) {
+    & $pythonExe "$PSScriptRoot/../ciSchedule.py" @historyArgs record --xunit $xunitFile
+}
 $failureLogsEmpty = (-Not (Test-Path $failureLogs) -Or ((Get-ChildItem $failureLogs).Count -eq 0))
 Write-Host "##vso[task.setvariable variable=FAILURE_LOGS_EMPTY]$failureLogsEmpty"
 $azcopyLogsEmpty = ((Get-ChildItem $env:AZCOPY_LOG_LOCATION).Count -eq 0)
@@ -50,6 +50,7 @@ option(X_VCPKG_APPLOCAL_DEPS_SERIALIZED "(experimental) Add USES_TERMINAL to VCP
 
 # requires CMake 3.14
 option(X_VCPKG_APPLOCAL_DEPS_INSTALL "(experimental) Automatically copy dependencies into the install target directory for executables. Requires CMake 3.14." OFF)
+option(X_VCPKG_LOW_OVERHEAD "(experimental) Only override add_executable(), add_library() and install() when app-local deployment or Visual Studio integration applies." OFF)
 option(VCPKG_PREFER_SYSTEM_LIBS "Appends the vcpkg paths to CMAKE_PREFIX_PATH, CMAKE_LIBRARY_PATH and CMAKE_FIND_ROOT_PATH so that vcpkg libraries/packages are found after toolchain/system libraries/packages." OFF)
 if(VCPKG_PREFER_SYSTEM_LIBS)
     message(WARNING "VCPKG_PREFER_SYSTEM_LIBS has been deprecated. Use empty overlay ports instead.")
@@ -107,6 +108,15 @@ Install the dependencies listed in your manifest:
     "VCPKG_MANIFEST_MODE"
     OFF)
 
+CMAKE_DEPENDENT_OPTION(X_VCPKG_MANIFEST_INSTALL_STAMP [[
+(experimental) Skip vcpkg install when nothing it depends on changed since the last successful install:
+    The manifest, vcpkg-configuration.json, triplets, overlays, features, install options and the installed tree are fingerprinted.
+    Edits to port files in the vcpkg root or the overlays are not detected; delete vcpkg-manifest-install.stamp to force an install.
+]]
+    OFF
+    "VCPKG_MANIFEST_INSTALL"
+    OFF)
+
 if(VCPKG_MANIFEST_INSTALL)
     set(VCPKG_BOOTSTRAP_OPTIONS "${VCPKG_BOOTSTRAP_OPTIONS}" CACHE STRING "Additional options to bootstrap vcpkg" FORCE)
     set(VCPKG_OVERLAY_PORTS "${VCPKG_OVERLAY_PORTS}" CACHE STRING "Overlay ports to use for vcpkg install in manifest mode" FORCE)
@@ -476,6 +486,54 @@ else()
     set(Z_VCPKG_BOOTSTRAP_SCRIPT "${Z_VCPKG_ROOT_DIR}/bootstrap-vcpkg.sh")
 endif()
 
+# Fingerprints everything the manifest install depends on, except for the port files themselves.
+# The files which went into the fingerprint are returned in FILES_VAR.
+function(z_vcpkg_manifest_install_fingerprint OUT_VAR FILES_VAR)
+    set(z_vcpkg_fingerprint "")
+    foreach(z_vcpkg_name IN ITEMS VCPKG_TARGET_TRIPLET VCPKG_HOST_TRIPLET Z_VCPKG_ROOT_DIR VCPKG_MANIFEST_DIR _VCPKG_INSTALLED_DIR
+            VCPKG_OVERLAY_PORTS VCPKG_OVERLAY_TRIPLETS VCPKG_MANIFEST_FEATURES VCPKG_MANIFEST_NO_DEFAULT_FEATURES
+            VCPKG_FEATURE_FLAGS VCPKG_INSTALL_OPTIONS)
+        string(APPEND z_vcpkg_fingerprint "${z_vcpkg_name}=${${z_vcpkg_name}}\n")
+    endforeach()
+    if(EXISTS "${Z_VCPKG_EXECUTABLE}")
+        file(TIMESTAMP "${Z_VCPKG_EXECUTABLE}" z_vcpkg_timestamp "%Y-%m-%dT%H:%M:%S" UTC)
+        string(APPEND z_vcpkg_fingerprint "${Z_VCPKG_EXECUTABLE}=${z_vcpkg_timestamp}\n")
+    endif()
+
+    set(z_vcpkg_files
+        "${VCPKG_MANIFEST_DIR}/vcpkg.json"
+        "${VCPKG_MANIFEST_DIR}/vcpkg-configuration.json"
+        "${_VCPKG_INSTALLED_DIR}/vcpkg/status"
+    )
+    # vcpkg records new installs in vcpkg/updates before merging them into vcpkg/status
+    file(GLOB z_vcpkg_updates "${_VCPKG_INSTALLED_DIR}/vcpkg/updates/*")
+    list(SORT z_vcpkg_updates)
+    list(APPEND z_vcpkg_files ${z_vcpkg_updates})
+    foreach(z_vcpkg_triplet_dir IN LISTS VCPKG_OVERLAY_TRIPLETS ITEMS "${Z_VCPKG_ROOT_DIR}/triplets" "${Z_VCPKG_ROOT_DIR}/triplets/community")
+        foreach(z_vcpkg_triplet IN ITEMS "${VCPKG_TARGET_TRIPLET}" "${VCPKG_HOST_TRIPLET}")
+            if(NOT z_vcpkg_triplet STREQUAL "" AND EXISTS "${z_vcpkg_triplet_dir}/${z_vcpkg_triplet}.cmake")
+                list(APPEND z_vcpkg_files "${z_vcpkg_triplet_dir}/${z_vcpkg_triplet}.cmake")
+            endif()
+        endforeach()
+    endforeach()
+    list(REMOVE_DUPLICATES z_vcpkg_files)
+
+    set(z_vcpkg_existing_files "")
+    foreach(z_vcpkg_file IN LISTS z_vcpkg_files)
+        if(EXISTS "${z_vcpkg_file}")
+            file(SHA256 "${z_vcpkg_file}" z_vcpkg_hash)
+            list(APPEND z_vcpkg_existing_files "${z_vcpkg_file}")
+        else()
+            set(z_vcpkg_hash "missing")
+        endif()
+        string(APPEND z_vcpkg_fingerprint "${z_vcpkg_file}=${z_vcpkg_hash}\n")
+    endforeach()
+
+    string(SHA256 z_vcpkg_fingerprint "${z_vcpkg_fingerprint}")
+    set("${OUT_VAR}" "${z_vcpkg_fingerprint}" PARENT_SCOPE)
+    set("${FILES_VAR}" "${z_vcpkg_existing_files}" PARENT_SCOPE)
+endfunction()
+
 if(VCPKG_MANIFEST_MODE AND VCPKG_MANIFEST_INSTALL AND NOT Z_VCPKG_CMAKE_IN_TRY_COMPILE AND NOT Z_VCPKG_HAS_FATAL_ERROR)
     if(NOT EXISTS "${Z_VCPKG_EXECUTABLE}" AND NOT Z_VCPKG_HAS_FATAL_ERROR)
         message(STATUS "Bootstrapping vcpkg before install")
@@ -496,7 +554,18 @@ if(VCPKG_MANIFEST_MODE AND VCPKG_MANIFEST_INSTALL AND NOT Z_VCPKG_CMAKE_IN_TRY_C
         endif()
     endif()
 
-    if(NOT Z_VCPKG_HAS_FATAL_ERROR)
+    set(Z_VCPKG_MANIFEST_INSTALL_STAMP "${CMAKE_BINARY_DIR}/vcpkg-manifest-install.stamp")
+    set(Z_VCPKG_MANIFEST_INSTALL_SKIPPED OFF)
+    if(X_VCPKG_MANIFEST_INSTALL_STAMP AND NOT Z_VCPKG_HAS_FATAL_ERROR AND EXISTS "${Z_VCPKG_MANIFEST_INSTALL_STAMP}")
+        file(READ "${Z_VCPKG_MANIFEST_INSTALL_STAMP}" Z_VCPKG_MANIFEST_INSTALL_STAMP_FINGERPRINT)
+        z_vcpkg_manifest_install_fingerprint(Z_VCPKG_MANIFEST_INSTALL_FINGERPRINT Z_VCPKG_MANIFEST_INSTALL_INPUTS)
+        if(Z_VCPKG_MANIFEST_INSTALL_FINGERPRINT STREQUAL Z_VCPKG_MANIFEST_INSTALL_STAMP_FINGERPRINT)
+            message(STATUS "Running vcpkg install - skipped, nothing changed since the last install")
+            set(Z_VCPKG_MANIFEST_INSTALL_SKIPPED ON)
+        endif()
+    endif()
+
+    if(NOT Z_VCPKG_HAS_FATAL_ERROR AND NOT Z_VCPKG_MANIFEST_INSTALL_SKIPPED)
         message(STATUS "Running vcpkg install")
 
         set(Z_VCPKG_ADDITIONAL_MANIFEST_PARAMS)
@@ -563,11 +632,21 @@ if(VCPKG_MANIFEST_MODE AND VCPKG_MANIFEST_INSTALL AND NOT Z_VCPKG_CMAKE_IN_TRY_C
                 set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS
                     "${VCPKG_MANIFEST_DIR}/vcpkg-configuration.json")
             endif()
+            if(X_VCPKG_MANIFEST_INSTALL_STAMP)
+                z_vcpkg_manifest_install_fingerprint(Z_VCPKG_MANIFEST_INSTALL_FINGERPRINT Z_VCPKG_MANIFEST_INSTALL_INPUTS)
+                file(WRITE "${Z_VCPKG_MANIFEST_INSTALL_STAMP}" "${Z_VCPKG_MANIFEST_INSTALL_FINGERPRINT}")
+            endif()
         else()
             message(STATUS "Running vcpkg install - failed")
+            file(REMOVE "${Z_VCPKG_MANIFEST_INSTALL_STAMP}")
             z_vcpkg_add_fatal_error("vcpkg install failed. See logs for more information: ${Z_NATIVE_VCPKG_MANIFEST_INSTALL_LOGFILE}")
         endif()
     endif()
+
+    if(X_VCPKG_MANIFEST_INSTALL_STAMP AND NOT Z_VCPKG_HAS_FATAL_ERROR)
+        # Rerun the configure, and with it the fingerprint check, whenever one of its input files changes.
+        set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${Z_VCPKG_MANIFEST_INSTALL_INPUTS})
+    endif()
 endif()
 
 option(VCPKG_SETUP_CMAKE_PROGRAM_PATH  "Enable the setup of CMAKE_PROGRAM_PATH to vcpkg paths" ON)
@@ -607,71 +686,86 @@ endif()
 
 cmake_policy(POP)
 
-function(add_executable)
-    z_vcpkg_function_arguments(ARGS)
-    _add_executable(${ARGS})
-    set(target_name "${ARGV0}")
-
-    list(FIND ARGV "IMPORTED" IMPORTED_IDX)
-    list(FIND ARGV "ALIAS" ALIAS_IDX)
-    list(FIND ARGV "MACOSX_BUNDLE" MACOSX_BUNDLE_IDX)
-    if(IMPORTED_IDX EQUAL "-1" AND ALIAS_IDX EQUAL "-1")
-        if(VCPKG_APPLOCAL_DEPS)
-            if(Z_VCPKG_TARGET_TRIPLET_PLAT MATCHES "windows|uwp|xbox")
-                z_vcpkg_set_powershell_path()
-                set(EXTRA_OPTIONS "")
-                if(X_VCPKG_APPLOCAL_DEPS_SERIALIZED)
-                    set(EXTRA_OPTIONS USES_TERMINAL)
+# The add_executable() and add_library() overrides only deploy dependencies app-locally and
+# disable the vcpkg MSBuild integration for Visual Studio projects.
+# With X_VCPKG_LOW_OVERHEAD, they are only installed when one of these can apply.
+set(Z_VCPKG_OVERRIDE_ADD_TARGET ON)
+if(X_VCPKG_LOW_OVERHEAD AND NOT CMAKE_GENERATOR MATCHES "^Visual Studio"
+        AND NOT (VCPKG_APPLOCAL_DEPS AND Z_VCPKG_TARGET_TRIPLET_PLAT MATCHES "windows|uwp|xbox|osx"))
+    set(Z_VCPKG_OVERRIDE_ADD_TARGET OFF)
+endif()
+
+if(Z_VCPKG_OVERRIDE_ADD_TARGET)
+    function(add_executable)
+        z_vcpkg_function_arguments(ARGS)
+        _add_executable(${ARGS})
+        set(target_name "${ARGV0}")
+
+        list(FIND ARGV "IMPORTED" IMPORTED_IDX)
+        list(FIND ARGV "ALIAS" ALIAS_IDX)
+        list(FIND ARGV "MACOSX_BUNDLE" MACOSX_BUNDLE_IDX)
+        if(IMPORTED_IDX EQUAL "-1" AND ALIAS_IDX EQUAL "-1")
+            if(VCPKG_APPLOCAL_DEPS)
+                if(Z_VCPKG_TARGET_TRIPLET_PLAT MATCHES "windows|uwp|xbox")
+                    z_vcpkg_set_powershell_path()
+                    set(EXTRA_OPTIONS "")
+                    if(X_VCPKG_APPLOCAL_DEPS_SERIALIZED)
+                        set(EXTRA_OPTIONS USES_TERMINAL)
+                    endif()
+                    add_custom_command(TARGET "${target_name}" POST_BUILD
+                        COMMAND "${Z_VCPKG_POWERSHELL_PATH}" -noprofile -executionpolicy Bypass -file "${Z_VCPKG_TOOLCHAIN_DIR}/msbuild/applocal.ps1"
+                            -targetBinary "$<TARGET_FILE:${target_name}>"
+                            -installedDir "${_VCPKG_INSTALLED_DIR}/${VCPKG_TARGET_TRIPLET}$<$<CONFIG:Debug>:/debug>/bin"
+                            -OutVariable out
+                        VERBATIM
+                        ${EXTRA_OPTIONS}
+                    )
+                elseif(Z_VCPKG_TARGET_TRIPLET_PLAT MATCHES "osx")
+                    if(NOT MACOSX_BUNDLE_IDX EQUAL "-1")
+                        find_package(Python COMPONENTS Interpreter)
+                        add_custom_command(TARGET "${target_name}" POST_BUILD
+                            COMMAND "${Python_EXECUTABLE}" "${Z_VCPKG_TOOLCHAIN_DIR}/osx/applocal.py"
+                                "$<TARGET_FILE:${target_name}>"
+                                "${_VCPKG_INSTALLED_DIR}/${VCPKG_TARGET_TRIPLET}$<$<CONFIG:Debug>:/debug>"
+                            VERBATIM
+                        )
+                    endif()
                 endif()
+            endif()
+            set_target_properties("${target_name}" PROPERTIES
+                VS_USER_PROPS do_not_import_user.props
+                VS_GLOBAL_VcpkgEnabled false
+            )
+        endif()
+    endfunction()
+
+    function(add_library)
+        z_vcpkg_function_arguments(ARGS)
+        _add_library(${ARGS})
+        set(target_name "${ARGV0}")
+
+        list(FIND ARGS "IMPORTED" IMPORTED_IDX)
+        list(FIND ARGS "INTERFACE" INTERFACE_IDX)
+        list(FIND ARGS "ALIAS" ALIAS_IDX)
+        if(IMPORTED_IDX EQUAL "-1" AND INTERFACE_IDX EQUAL "-1" AND ALIAS_IDX EQUAL "-1")
+            get_target_property(IS_LIBRARY_SHARED "${target_name}" TYPE)
+            if(VCPKG_APPLOCAL_DEPS AND Z_VCPKG_TARGET_TRIPLET_PLAT MATCHES "windows|uwp|xbox" AND (IS_LIBRARY_SHARED STREQUAL "SHARED_LIBRARY" OR IS_LIBRARY_SHARED STREQUAL "MODULE_LIBRARY"))
+                z_vcpkg_set_powershell_path()
                 add_custom_command(TARGET "${target_name}" POST_BUILD
                     COMMAND "${Z_VCPKG_POWERSHELL_PATH}" -noprofile -executionpolicy Bypass -file "${Z_VCPKG_TOOLCHAIN_DIR}/msbuild/applocal.ps1"
                         -targetBinary "$<TARGET_FILE:${target_name}>"
                         -installedDir "${_VCPKG_INSTALLED_DIR}/${VCPKG_TARGET_TRIPLET}$<$<CONFIG:Debug>:/debug>/bin"
                         -OutVariable out
-                    VERBATIM
-                    ${EXTRA_OPTIONS}
-                )
-            elseif(Z_VCPKG_TARGET_TRIPLET_PLAT MATCHES "osx")
-                if(NOT MACOSX_BUNDLE_IDX EQUAL "-1")
-                    find_package(Python COMPONENTS Interpreter)
-                    add_custom_command(TARGET "${target_name}" POST_BUILD
-                        COMMAND "${Python_EXECUTABLE}" "${Z_VCPKG_TOOLCHAIN_DIR}/osx/applocal.py"
-                            "$<TARGET_FILE:${target_name}>"
-                            "${_VCPKG_INSTALLED_DIR}/${VCPKG_TARGET_TRIPLET}$<$<CONFIG:Debug>:/debug>"
                         VERBATIM
-                    )
-                endif()
+                )
             endif()
-        endif()
-        set_target_properties("${target_name}" PROPERTIES VS_USER_PROPS do_not_import_user.props)
-        set_target_properties("${target_name}" PROPERTIES VS_GLOBAL_VcpkgEnabled false)
-    endif()
-endfunction()
-
-function(add_library)
-    z_vcpkg_function_arguments(ARGS)
-    _add_library(${ARGS})
-    set(target_name "${ARGV0}")
-
-    list(FIND ARGS "IMPORTED" IMPORTED_IDX)
-    list(FIND ARGS "INTERFACE" INTERFACE_IDX)
-    list(FIND ARGS "ALIAS" ALIAS_IDX)
-    if(IMPORTED_IDX EQUAL "-1" AND INTERFACE_IDX EQUAL "-1" AND ALIAS_IDX EQUAL "-1")
-        get_target_property(IS_LIBRARY_SHARED "${target_name}" TYPE)
-        if(VCPKG_APPLOCAL_DEPS AND Z_VCPKG_TARGET_TRIPLET_PLAT MATCHES "windows|uwp|xbox" AND (IS_LIBRARY_SHARED STREQUAL "SHARED_LIBRARY" OR IS_LIBRARY_SHARED STREQUAL "MODULE_LIBRARY"))
-            z_vcpkg_set_powershell_path()
-            add_custom_command(TARGET "${target_name}" POST_BUILD
-                COMMAND "${Z_VCPKG_POWERSHELL_PATH}" -noprofile -executionpolicy Bypass -file "${Z_VCPKG_TOOLCHAIN_DIR}/msbuild/applocal.ps1"
-                    -targetBinary "$<TARGET_FILE:${target_name}>"
-                    -installedDir "${_VCPKG_INSTALLED_DIR}/${VCPKG_TARGET_TRIPLET}$<$<CONFIG:Debug>:/debug>/bin"
-                    -OutVariable out
-                    VERBATIM
+            set_target_properties("${target_name}" PROPERTIES
+                VS_USER_PROPS do_not_import_user.props
+                VS_GLOBAL_VcpkgEnabled false
             )
         endif()
-        set_target_properties("${target_name}" PROPERTIES VS_USER_PROPS do_not_import_user.props)
-        set_target_properties("${target_name}" PROPERTIES VS_GLOBAL_VcpkgEnabled false)
-    endif()
-endfunction()
+    endfunction()
+endif()
 
 # This is an experimental function to enable applocal install of dependencies as part of the `make install` process
 # Arguments:
@@ -729,7 +823,7 @@ function(x_vcpkg_install_local_dependencies)
     endif()
 endfunction()
 
-if(X_VCPKG_APPLOCAL_DEPS_INSTALL)
+if(X_VCPKG_APPLOCAL_DEPS_INSTALL AND NOT (X_VCPKG_LOW_OVERHEAD AND NOT Z_VCPKG_TARGET_TRIPLET_PLAT MATCHES "^(windows|uwp|xbox-.*)$"))
     function(install)
         z_vcpkg_function_arguments(ARGS)
         _install(${ARGS})
@@ -778,6 +872,160 @@ if(X_VCPKG_APPLOCAL_DEPS_INSTALL)
 endif()
 
 option(VCPKG_TRACE_FIND_PACKAGE "Trace calls to find_package()" OFF)
+option(X_VCPKG_FIND_PACKAGE_INDEX "(experimental) Resolve find_package() calls for packages in the installed tree from an index instead of searching the prefixes." OFF)
+option(X_VCPKG_CONSOLIDATED_CONFIGS "(experimental) Load the single-file <PackageName>-consolidated.cmake configs written by vcpkg_cmake_config_consolidate(). Implies X_VCPKG_FIND_PACKAGE_INDEX." OFF)
+
+# Writes an index of the config packages and vcpkg-cmake-wrapper.cmake files below the triplet's prefixes.
+# A package is only indexed when exactly one directory could satisfy it, i.e. when CMake's search
+# is known to end there; everything else is left to the normal search.
+function(z_vcpkg_write_find_package_index INDEX_FILE KEY)
+    set(z_vcpkg_prefix "${_VCPKG_INSTALLED_DIR}/${VCPKG_TARGET_TRIPLET}")
+    # The config directories find_package() searches below each prefix. <name> stands for a
+    # directory whose name starts with the package name, ignoring case.
+    set(z_vcpkg_layouts
+        "." "[Cc][Mm]ake" "<name>" "<name>/[Cc][Mm]ake" "<name>/[Cc][Mm]ake/<name>"
+        "lib*/cmake/<name>" "share/cmake/<name>"
+        "lib*/<name>" "share/<name>"
+        "lib*/<name>/[Cc][Mm]ake" "share/<name>/[Cc][Mm]ake"
+        "<name>/lib*/cmake/<name>" "<name>/share/cmake/<name>"
+        "<name>/lib*/<name>" "<name>/share/<name>"
+        "<name>/lib*/<name>/[Cc][Mm]ake" "<name>/share/<name>/[Cc][Mm]ake"
+    )
+    set(z_vcpkg_names "")
+    foreach(z_vcpkg_root IN ITEMS "${z_vcpkg_prefix}" "${z_vcpkg_prefix}/debug")
+        foreach(z_vcpkg_layout IN LISTS z_vcpkg_layouts)
+            if(z_vcpkg_layout STREQUAL ".")
+                set(z_vcpkg_layout_glob "${z_vcpkg_root}")
+            else()
+                string(REPLACE "<name>" "*" z_vcpkg_layout_glob "${z_vcpkg_root}/${z_vcpkg_layout}")
+            endif()
+            file(GLOB z_vcpkg_configs LIST_DIRECTORIES false
+                "${z_vcpkg_layout_glob}/*Config.cmake"
+                "${z_vcpkg_layout_glob}/*-config.cmake"
+            )
+            string(REPLACE "/" ";" z_vcpkg_layout_components "${z_vcpkg_layout}")
+            list(LENGTH z_vcpkg_layout_components z_vcpkg_layout_length)
+            foreach(z_vcpkg_config IN LISTS z_vcpkg_configs)
+                get_filename_component(z_vcpkg_config_dir "${z_vcpkg_config}" DIRECTORY)
+                get_filename_component(z_vcpkg_config_name "${z_vcpkg_config}" NAME)
+                if(z_vcpkg_config_name MATCHES "^([A-Za-z0-9_.+-]+)Config\\.cmake$")
+                    # <PackageName>Config.cmake only satisfies find_package(<PackageName>)
+                    set(z_vcpkg_name "CONFIG_${CMAKE_MATCH_1}")
+                elseif(z_vcpkg_config_name MATCHES "^([a-z0-9_.+-]+)-config\\.cmake$")
+                    # <lowercasePackageName>-config.cmake satisfies find_package(<PackageName>) for any case
+                    set(z_vcpkg_name "LOWER_${CMAKE_MATCH_1}")
+                else()
+                    continue()
+                endif()
+                # CMake only looks into directories named <PackageName>*, ignoring case.
+                string(TOLOWER "${CMAKE_MATCH_1}" z_vcpkg_lowercase_name)
+                file(RELATIVE_PATH z_vcpkg_config_relative_dir "${z_vcpkg_root}" "${z_vcpkg_config_dir}")
+                string(REPLACE "/" ";" z_vcpkg_config_components "${z_vcpkg_config_relative_dir}")
+                set(z_vcpkg_matches ON)
+                foreach(z_vcpkg_component_index RANGE 1 "${z_vcpkg_layout_length}")
+                    math(EXPR z_vcpkg_component_index "${z_vcpkg_component_index} - 1")
+                    list(GET z_vcpkg_layout_components "${z_vcpkg_component_index}" z_vcpkg_layout_component)
+                    if(z_vcpkg_layout_component STREQUAL "<name>")
+                        list(GET z_vcpkg_config_components "${z_vcpkg_component_index}" z_vcpkg_config_component)
+                        string(TOLOWER "${z_vcpkg_config_component}" z_vcpkg_lowercase_dir_name)
+                        string(FIND "${z_vcpkg_lowercase_dir_name}" "${z_vcpkg_lowercase_name}" z_vcpkg_index)
+                        if(NOT z_vcpkg_index EQUAL "0")
+                            set(z_vcpkg_matches OFF)
+                        endif()
+                    endif()
+                endforeach()
+                if(z_vcpkg_matches)
+                    list(APPEND z_vcpkg_names "${z_vcpkg_name}")
+                    list(APPEND "z_vcpkg_dirs_${z_vcpkg_name}" "${z_vcpkg_config_dir}")
+                endif()
+            endforeach()
+        endforeach()
+    endforeach()
+    if(NOT z_vcpkg_names STREQUAL "")
+        list(REMOVE_DUPLICATES z_vcpkg_names)
+    endif()
+
+    set(z_vcpkg_contents "set(Z_VCPKG_FIND_PACKAGE_INDEX_KEY \"${KEY}\")\n")
+    foreach(z_vcpkg_name IN LISTS z_vcpkg_names)
+        list(REMOVE_DUPLICATES "z_vcpkg_dirs_${z_vcpkg_name}")
+        list(LENGTH "z_vcpkg_dirs_${z_vcpkg_name}" z_vcpkg_count)
+        if(NOT z_vcpkg_count EQUAL "1")
+            set("z_vcpkg_dirs_${z_vcpkg_name}" "ambiguous")
+        endif()
+        string(APPEND z_vcpkg_contents "set(Z_VCPKG_FIND_PACKAGE_INDEX_${z_vcpkg_name} \"${z_vcpkg_dirs_${z_vcpkg_name}}\")\n")
+    endforeach()
+    file(GLOB z_vcpkg_wrappers "${z_vcpkg_prefix}/share/*/vcpkg-cmake-wrapper.cmake")
+    foreach(z_vcpkg_wrapper IN LISTS z_vcpkg_wrappers)
+        get_filename_component(z_vcpkg_wrapper_dir "${z_vcpkg_wrapper}" DIRECTORY)
+        get_filename_component(z_vcpkg_wrapper_dir_name "${z_vcpkg_wrapper_dir}" NAME)
+        # find_package() looks up wrappers by the lowercase package name, but ports may install them
+        # into mixed-case directories (e.g. share/PThreads_windows).
+        string(TOLOWER "${z_vcpkg_wrapper_dir_name}" z_vcpkg_wrapper_dir_name)
+        string(APPEND z_vcpkg_contents "set(\"Z_VCPKG_FIND_PACKAGE_INDEX_WRAPPER_${z_vcpkg_wrapper_dir_name}\" \"${z_vcpkg_wrapper}\")\n")
+    endforeach()
+    file(GLOB z_vcpkg_consolidated_configs "${z_vcpkg_prefix}/share/*/*-consolidated.cmake")
+    foreach(z_vcpkg_consolidated_config IN LISTS z_vcpkg_consolidated_configs)
+        get_filename_component(z_vcpkg_consolidated_dir "${z_vcpkg_consolidated_config}" DIRECTORY)
+        get_filename_component(z_vcpkg_consolidated_dir_name "${z_vcpkg_consolidated_dir}" NAME)
+        if(EXISTS "${z_vcpkg_consolidated_dir}/${z_vcpkg_consolidated_dir_name}-consolidated.cmake")
+            string(APPEND z_vcpkg_contents "set(\"Z_VCPKG_FIND_PACKAGE_INDEX_CONSOLIDATED_${z_vcpkg_consolidated_dir_name}\" ON)\n")
+        endif()
+    endforeach()
+    file(WRITE "${INDEX_FILE}" "${z_vcpkg_contents}")
+endfunction()
+
+# Loads the find_package index, regenerating it whenever vcpkg installed or removed something.
+function(z_vcpkg_load_find_package_index)
+    set(z_vcpkg_index_file "${CMAKE_BINARY_DIR}/vcpkg-find-package-index-${VCPKG_TARGET_TRIPLET}.cmake")
+    set(z_vcpkg_key "${_VCPKG_INSTALLED_DIR}/${VCPKG_TARGET_TRIPLET}")
+    if(EXISTS "${_VCPKG_INSTALLED_DIR}/vcpkg/status")
+        file(SHA256 "${_VCPKG_INSTALLED_DIR}/vcpkg/status" z_vcpkg_status_hash)
+        string(APPEND z_vcpkg_key ";${z_vcpkg_status_hash}")
+    endif()
+    file(GLOB z_vcpkg_updates RELATIVE "${_VCPKG_INSTALLED_DIR}/vcpkg/updates" "${_VCPKG_INSTALLED_DIR}/vcpkg/updates/*")
+    list(SORT z_vcpkg_updates)
+    string(SHA256 z_vcpkg_key "${z_vcpkg_key};${z_vcpkg_updates}")
+
+    if(EXISTS "${z_vcpkg_index_file}")
+        include("${z_vcpkg_index_file}")
+    endif()
+    if(NOT Z_VCPKG_FIND_PACKAGE_INDEX_KEY STREQUAL z_vcpkg_key)
+        z_vcpkg_write_find_package_index("${z_vcpkg_index_file}" "${z_vcpkg_key}")
+    endif()
+    set(Z_VCPKG_FIND_PACKAGE_INDEX_FILE "${z_vcpkg_index_file}" PARENT_SCOPE)
+endfunction()
+
+if((X_VCPKG_FIND_PACKAGE_INDEX OR X_VCPKG_CONSOLIDATED_CONFIGS) AND NOT VCPKG_PREFER_SYSTEM_LIBS AND NOT Z_VCPKG_CMAKE_IN_TRY_COMPILE AND NOT Z_VCPKG_HAS_FATAL_ERROR)
+    z_vcpkg_load_find_package_index()
+    include("${Z_VCPKG_FIND_PACKAGE_INDEX_FILE}")
+endif()
+
+# Checks that HINTS and PATHS passed to find_package() cannot lead the search away from the indexed
+# directory, i.e. that they only name the installed prefix, its config roots or the directory itself.
+function(z_vcpkg_find_package_hints_in_index INDEX_DIR OUT_VAR)
+    set(z_vcpkg_prefix "${_VCPKG_INSTALLED_DIR}/${VCPKG_TARGET_TRIPLET}")
+    get_filename_component(z_vcpkg_index_parent "${INDEX_DIR}" DIRECTORY)
+    set(z_vcpkg_allowed "${z_vcpkg_prefix}" "${z_vcpkg_prefix}/share" "${z_vcpkg_prefix}/lib/cmake" "${z_vcpkg_index_parent}" "${INDEX_DIR}")
+    set(z_vcpkg_in_paths OFF)
+    foreach(z_vcpkg_arg IN LISTS ARGN)
+        if(z_vcpkg_arg MATCHES "^(HINTS|PATHS)$")
+            set(z_vcpkg_in_paths ON)
+        elseif(z_vcpkg_arg MATCHES "^(ENV|PATH_SUFFIXES)$")
+            set("${OUT_VAR}" OFF PARENT_SCOPE)
+            return()
+        elseif(z_vcpkg_arg MATCHES "^(REGISTRY_VIEW|EXACT|QUIET|REQUIRED|COMPONENTS|OPTIONAL_COMPONENTS|CONFIG|NO_MODULE|GLOBAL|NO_POLICY_SCOPE|BYPASS_PROVIDER|NO_[A-Z_]+|ONLY_CMAKE_FIND_ROOT_PATH|CMAKE_FIND_ROOT_PATH_BOTH)$")
+            set(z_vcpkg_in_paths OFF)
+        elseif(z_vcpkg_in_paths)
+            get_filename_component(z_vcpkg_path "${z_vcpkg_arg}" ABSOLUTE)
+            if(NOT z_vcpkg_path IN_LIST z_vcpkg_allowed)
+                set("${OUT_VAR}" OFF PARENT_SCOPE)
+                return()
+            endif()
+        endif()
+    endforeach()
+    set("${OUT_VAR}" ON PARENT_SCOPE)
+endfunction()
+
 if(NOT DEFINED VCPKG_OVERRIDE_FIND_PACKAGE_NAME)
     set(VCPKG_OVERRIDE_FIND_PACKAGE_NAME find_package)
 endif()
@@ -845,10 +1093,89 @@ macro("${VCPKG_OVERRIDE_FIND_PACKAGE_NAME}" z_vcpkg_find_package_package_name)
     string(TOLOWER "${z_vcpkg_find_package_package_name}" z_vcpkg_find_package_lowercase_package_name)
     set(z_vcpkg_find_package_vcpkg_cmake_wrapper_path
         "${_VCPKG_INSTALLED_DIR}/${VCPKG_TARGET_TRIPLET}/share/${z_vcpkg_find_package_lowercase_package_name}/vcpkg-cmake-wrapper.cmake")
+    if(DEFINED Z_VCPKG_FIND_PACKAGE_INDEX_KEY)
+        if(DEFINED "Z_VCPKG_FIND_PACKAGE_INDEX_WRAPPER_${z_vcpkg_find_package_lowercase_package_name}")
+            set(z_vcpkg_find_package_has_wrapper ON)
+            set(z_vcpkg_find_package_vcpkg_cmake_wrapper_path "${Z_VCPKG_FIND_PACKAGE_INDEX_WRAPPER_${z_vcpkg_find_package_lowercase_package_name}}")
+        else()
+            set(z_vcpkg_find_package_has_wrapper OFF)
+        endif()
+        # <PackageName>_ROOT is searched before the prefixes, also by the nested find_package() calls.
+        string(TOUPPER "${z_vcpkg_find_package_package_name}" z_vcpkg_find_package_uppercase_package_name)
+        if(NOT DEFINED z_vcpkg_find_package_root_id
+                AND (DEFINED "${z_vcpkg_find_package_package_name}_ROOT" OR DEFINED "ENV{${z_vcpkg_find_package_package_name}_ROOT}"
+                    OR DEFINED "${z_vcpkg_find_package_uppercase_package_name}_ROOT" OR DEFINED "ENV{${z_vcpkg_find_package_uppercase_package_name}_ROOT}")
+                AND NOT (DEFINED CMAKE_FIND_USE_PACKAGE_ROOT_PATH AND NOT CMAKE_FIND_USE_PACKAGE_ROOT_PATH))
+            set(z_vcpkg_find_package_root_id "${z_vcpkg_find_package_backup_id}")
+        endif()
+        unset(z_vcpkg_find_package_uppercase_package_name)
+        # Point CMake at the config directory unless the call or the user directs the search.
+        set(z_vcpkg_find_package_index_dir "${Z_VCPKG_FIND_PACKAGE_INDEX_CONFIG_${z_vcpkg_find_package_package_name}}")
+        if(z_vcpkg_find_package_index_dir STREQUAL "")
+            set(z_vcpkg_find_package_index_dir "${Z_VCPKG_FIND_PACKAGE_INDEX_LOWER_${z_vcpkg_find_package_lowercase_package_name}}")
+        elseif(DEFINED "Z_VCPKG_FIND_PACKAGE_INDEX_LOWER_${z_vcpkg_find_package_lowercase_package_name}"
+                AND NOT Z_VCPKG_FIND_PACKAGE_INDEX_LOWER_${z_vcpkg_find_package_lowercase_package_name} STREQUAL z_vcpkg_find_package_index_dir)
+            set(z_vcpkg_find_package_index_dir "ambiguous")
+        endif()
+        if(NOT z_vcpkg_find_package_index_dir STREQUAL "" AND NOT z_vcpkg_find_package_index_dir STREQUAL "ambiguous"
+                AND NOT DEFINED z_vcpkg_find_package_root_id
+                AND NOT "${z_vcpkg_find_package_${z_vcpkg_find_package_backup_id}_ARGN}" MATCHES "(^|;)(MODULE|NAMES|CONFIGS|NO_DEFAULT_PATH|NO_CMAKE_PATH|NO_CMAKE_FIND_ROOT_PATH)(;|$)")
+            set(z_vcpkg_find_package_use_index ON)
+            if("${z_vcpkg_find_package_${z_vcpkg_find_package_backup_id}_ARGN}" MATCHES "(^|;)(HINTS|PATHS)(;|$)")
+                z_vcpkg_find_package_hints_in_index("${z_vcpkg_find_package_index_dir}" z_vcpkg_find_package_use_index
+                    ${z_vcpkg_find_package_${z_vcpkg_find_package_backup_id}_ARGN})
+            endif()
+        else()
+            set(z_vcpkg_find_package_use_index OFF)
+        endif()
+        if(z_vcpkg_find_package_use_index AND NOT DEFINED "${z_vcpkg_find_package_package_name}_DIR")
+            if(VCPKG_TRACE_FIND_PACKAGE)
+                string(REPEAT "  " "${z_vcpkg_find_package_backup_id}" z_vcpkg_find_package_indent)
+                message(STATUS "${z_vcpkg_find_package_indent}using ${z_vcpkg_find_package_package_name}_DIR=${z_vcpkg_find_package_index_dir} from the index")
+                unset(z_vcpkg_find_package_indent)
+            endif()
+            # This is the cache entry CMake would create after finding the package there.
+            set("${z_vcpkg_find_package_package_name}_DIR" "${z_vcpkg_find_package_index_dir}"
+                CACHE PATH "The directory containing a CMake configuration file for ${z_vcpkg_find_package_package_name}.")
+        endif()
+        if(X_VCPKG_CONSOLIDATED_CONFIGS AND z_vcpkg_find_package_use_index
+                AND "${${z_vcpkg_find_package_package_name}_DIR}" STREQUAL z_vcpkg_find_package_index_dir)
+            get_filename_component(z_vcpkg_find_package_index_dir_name "${z_vcpkg_find_package_index_dir}" NAME)
+            set(z_vcpkg_find_package_use_consolidated "${Z_VCPKG_FIND_PACKAGE_INDEX_CONSOLIDATED_${z_vcpkg_find_package_index_dir_name}}")
+            if(z_vcpkg_find_package_use_consolidated
+                    AND NOT "${z_vcpkg_find_package_${z_vcpkg_find_package_backup_id}_ARGN}" MATCHES "(^|;)(CONFIG|NO_MODULE)(;|$)"
+                    AND NOT CMAKE_FIND_PACKAGE_PREFER_CONFIG)
+                # The basic signature tries a find module first.
+                foreach(z_vcpkg_find_package_module_dir IN LISTS CMAKE_MODULE_PATH ITEMS "${CMAKE_ROOT}/Modules")
+                    if(EXISTS "${z_vcpkg_find_package_module_dir}/Find${z_vcpkg_find_package_package_name}.cmake")
+                        set(z_vcpkg_find_package_use_consolidated OFF)
+                        break()
+                    endif()
+                endforeach()
+                unset(z_vcpkg_find_package_module_dir)
+            endif()
+            if(z_vcpkg_find_package_use_consolidated)
+                if(VCPKG_TRACE_FIND_PACKAGE)
+                    string(REPEAT "  " "${z_vcpkg_find_package_backup_id}" z_vcpkg_find_package_indent)
+                    message(STATUS "${z_vcpkg_find_package_indent}using ${z_vcpkg_find_package_index_dir_name}-consolidated.cmake")
+                    unset(z_vcpkg_find_package_indent)
+                endif()
+                list(APPEND "z_vcpkg_find_package_${z_vcpkg_find_package_backup_id}_ARGN" CONFIGS "${z_vcpkg_find_package_index_dir_name}-consolidated.cmake")
+            endif()
+            unset(z_vcpkg_find_package_index_dir_name)
+            unset(z_vcpkg_find_package_use_consolidated)
+        endif()
+        unset(z_vcpkg_find_package_index_dir)
+        unset(z_vcpkg_find_package_use_index)
+    elseif(EXISTS "${z_vcpkg_find_package_vcpkg_cmake_wrapper_path}")
+        set(z_vcpkg_find_package_has_wrapper ON)
+    else()
+        set(z_vcpkg_find_package_has_wrapper OFF)
+    endif()
     if(CMAKE_DISABLE_FIND_PACKAGE_${z_vcpkg_find_package_package_name})
         # Skip wrappers, fail if REQUIRED.
         _find_package("${z_vcpkg_find_package_package_name}" ${z_vcpkg_find_package_${z_vcpkg_find_package_backup_id}_ARGN})
-    elseif(EXISTS "${z_vcpkg_find_package_vcpkg_cmake_wrapper_path}")
+    elseif(z_vcpkg_find_package_has_wrapper)
         if(VCPKG_TRACE_FIND_PACKAGE)
             string(REPEAT "  " "${z_vcpkg_find_package_backup_id}" z_vcpkg_find_package_indent)
             message(STATUS "${z_vcpkg_find_package_indent}using share/${z_vcpkg_find_package_lowercase_package_name}/vcpkg-cmake-wrapper.cmake")
@@ -917,6 +1244,9 @@ macro("${VCPKG_OVERRIDE_FIND_PACKAGE_NAME}" z_vcpkg_find_package_package_name)
         endif()
         unset("z_vcpkg_find_package_${z_vcpkg_find_package_backup_id}_backup_${z_vcpkg_find_package_${z_vcpkg_find_package_backup_id}_backup_var}")
     endforeach()
+    if("${z_vcpkg_find_package_root_id}" STREQUAL z_vcpkg_find_package_backup_id)
+        unset(z_vcpkg_find_package_root_id)
+    endif()
     math(EXPR z_vcpkg_find_package_backup_id "${z_vcpkg_find_package_backup_id} - 1")
     if(z_vcpkg_find_package_backup_id LESS "0")
         message(FATAL_ERROR "[vcpkg]: find_package ended with z_vcpkg_find_package_backup_id being less than 0! This is a logical error and should never happen. Please provide a cmake trace log via cmake cmd line option '--trace-expand'!")
@@ -0,0 +1,352 @@
+import os
+import re
+import sys
+import heapq
+import random
+import argparse
+import statistics
+import xml.etree.ElementTree as ElementTree
+
+from portDependencyGraph import PortGraph, load_manifests, load_ci_baseline, compute_impacted, \
+    get_changed_files, get_changed_ports, default_host_triplet, CI_BASELINE_PATH
+
+
+# Built when a port has no recorded duration and the history is empty.
+DEFAULT_DURATION = 60.0
+# Weight of a new measurement when recording; older measurements decay instead of being replaced.
+RECORD_WEIGHT = 0.5
+HISTORY_REGEX = re.compile(r'^([a-z0-9-]+):([a-z0-9-]+)\s*=\s*([0-9.]+)\s*(#.*)?$')
+
+
+def load_history(path):
+    """Returns {(port, triplet): seconds} of a history file in the format of ci.baseline.txt."""
+    history = {}
+    if path and os.path.exists(path):
+        with open(path, 'r') as history_file:
+            for line in history_file:
+                match = HISTORY_REGEX.match(line.strip())
+                if match:
+                    history[(match.group(1), match.group(2))] = float(match.group(3))
+    return history
+
+
+def write_history(path, history):
+    with open(path, 'w') as history_file:
+        history_file.write('# Build durations in seconds, measured by CI; see scripts/ciSchedule.py.\n')
+        for (port_name, triplet), seconds in sorted(history.items()):
+            history_file.write(f'{port_name}:{triplet}={seconds:.0f}\n')
+
+
+def read_xunit_durations(path):
+    """Returns {(port, triplet): seconds} of the built ports in an xunit file written by `vcpkg ci --x-xunit`."""
+    durations = {}
+    for test in ElementTree.parse(path).getroot().iter('test'):
+        port_name, _, triplet = test.get('name', '').partition(':')
+        if triplet and test.get('result') in ('Pass', 'Fail') and test.get('time'):
+            durations[(port_name, triplet)] = float(test.get('time'))
+    return durations
+
+
+class Durations:
+    """Estimated build durations: the recorded one, else the port's mean over other triplets, else the median."""
+
+    def __init__(self, history):
+        self.history = history
+        by_port = {}
+        for (port_name, _), seconds in history.items():
+            by_port.setdefault(port_name, []).append(seconds)
+        self.by_port = {port_name: statistics.mean(values) for port_name, values in by_port.items()}
+        self.default = statistics.median(history.values()) if history else DEFAULT_DURATION
+
+    def __getitem__(self, task):
+        if task in self.history:
+            return self.history[task]
+        return self.by_port.get(task[0], self.default)
+
+
+class Schedule:
+    """The ports a change requires CI to build on one triplet, as a graph of (port, triplet) tasks.
+
+    A task depends on the tasks of the ports its default features need. Dependencies which are
+    not tasks are unchanged and restored from the binary cache."""
+
+    def __init__(self, graph, ports, host_ports, durations):
+        self.graph = graph
+        self.durations = durations
+        rebuilt = {graph.triplet: ports, graph.host_triplet: host_ports}
+        self.tasks = {(port_name, graph.triplet) for port_name in ports}
+        self.dependencies = {}
+        pending = list(self.tasks)
+        while pending:
+            task = pending.pop()
+            self.dependencies[task] = [dependency for dependency in self._port_dependencies(task)
+                                       if dependency[0] in rebuilt[dependency[1]]]
+            for dependency in self.dependencies[task]:
+                if dependency not in self.tasks:
+                    self.tasks.add(dependency)
+                    pending.append(dependency)
+        self.order = self._topological_order()
+        self.dependents = {task: [] for task in self.tasks}
+        for task in self.order:
+            for dependency in self.dependencies[task]:
+                self.dependents[dependency].append(task)
+        self.rank = {}
+        for task in reversed(self.order):
+            self.rank[task] = durations[task] + max((self.rank[dependent] for dependent in self.dependents[task]),
+                                                    default=0.0)
+
+    def _port_dependencies(self, task):
+        port_name, triplet = task
+        own_nodes = [(port_name, 'default', triplet)]
+        seen = set(own_nodes)
+        dependencies = set()
+        while own_nodes:
+            for target in self.graph.edges.get(own_nodes.pop(), ()):
+                if target[0] != port_name:
+                    if target[0] in self.graph.manifests:
+                        dependencies.add((target[0], target[2]))
+                elif target not in seen:
+                    seen.add(target)
+                    own_nodes.append(target)
+        return sorted(dependencies)
+
+    def _topological_order(self):
+        # Dependency cycles through features are broken at the edge which closes them.
+        order = []
+        state = {}
+        for root in sorted(self.tasks):
+            if root in state:
+                continue
+            state[root] = 'active'
+            stack = [(root, iter(list(self.dependencies[root])))]
+            while stack:
+                task, dependencies = stack[-1]
+                for dependency in dependencies:
+                    if dependency not in state:
+                        state[dependency] = 'active'
+                        stack.append((dependency, iter(list(self.dependencies[dependency]))))
+                        break
+                    if state[dependency] == 'active':
+                        self.dependencies[task].remove(dependency)
+                else:
+                    stack.pop()
+                    state[task] = 'done'
+                    order.append(task)
+        return order
+
+    def total(self):
+        return sum(self.durations[task] for task in self.tasks)
+
+    def critical_path(self):
+        """The chain of tasks which bounds the makespan regardless of the number of agents."""
+        path = []
+        candidates = [task for task in self.tasks if not self.dependencies[task]]
+        while candidates:
+            task = max(candidates, key=lambda candidate: (self.rank[candidate], candidate))
+            path.append(task)
+            candidates = self.dependents[task]
+        return path
+
+    def closure(self, task):
+        result = {task}
+        pending = [task]
+        while pending:
+            for dependency in self.dependencies[pending.pop()]:
+                if dependency not in result:
+                    result.add(dependency)
+                    pending.append(dependency)
+        return result
+
+    def simulate_shared_queue(self, agent_count, priority, restore_seconds=0.0):
+        """Makespan of agents which each build one ready task at a time from a shared queue; results are
+        shared through the binary cache, so restoring one built by another agent costs restore_seconds."""
+        remaining = {task: len(self.dependencies[task]) for task in self.tasks}
+        ready = [(priority(task), task) for task, count in remaining.items() if count == 0]
+        heapq.heapify(ready)
+        idle_agents = list(range(agent_count))
+        built_on = {}
+        running = []
+        time = 0.0
+        while ready or running:
+            while ready and idle_agents:
+                _, task = heapq.heappop(ready)
+                agent = idle_agents.pop()
+                restores = sum(1 for dependency in self.dependencies[task] if built_on[dependency] != agent)
+                built_on[task] = agent
+                heapq.heappush(running, (time + self.durations[task] + restores * restore_seconds, agent, task))
+            time, agent, task = heapq.heappop(running)
+            idle_agents.append(agent)
+            for dependent in self.dependents[task]:
+                remaining[dependent] -= 1
+                if remaining[dependent] == 0:
+                    heapq.heappush(ready, (priority(dependent), dependent))
+        return time
+
+    def partition(self, agent_count, by_cost):
+        """Assigns the target triplet's tasks to agents. Each agent builds the dependency closure of its
+        tasks by itself, so the agents need no coordination; shared dependencies are built on each.
+
+        With by_cost, the heaviest tasks are placed first, each on the agent whose load it grows the
+        least. Otherwise tasks are dealt out in name order, which is what a partition without
+        durations does."""
+        loads = [0.0] * agent_count
+        agent_tasks = [set() for _ in range(agent_count)]
+        roots = sorted(task for task in self.tasks if task[1] == self.graph.triplet)
+        if by_cost:
+            roots.sort(key=lambda task: -self.rank[task])
+        for index, task in enumerate(roots):
+            if any(task in tasks for tasks in agent_tasks):
+                continue
+            closure = self.closure(task)
+            if by_cost:
+                costs = [sum(self.durations[other] for other in closure - tasks) for tasks in agent_tasks]
+                agent = min(range(agent_count), key=lambda candidate: (loads[candidate] + costs[candidate], candidate))
+                loads[agent] += costs[agent]
+            else:
+                agent = index % agent_count
+                loads[agent] += sum(self.durations[other] for other in closure - agent_tasks[agent])
+            agent_tasks[agent] |= closure
+        return agent_tasks, loads
+
+
+def build_schedule(args):
+    manifests = load_manifests()
+    host_triplet = args.host_triplet or default_host_triplet(args.triplet)
+    graph = PortGraph(manifests, args.triplet, host_triplet)
+    if args.all:
+        changed_ports = set(manifests)
+    else:
+        changed_files = list(args.files)
+        if args.since:
+            changed_files += get_changed_files(args.since)
+        changed_ports, reason = get_changed_ports(changed_files, manifests, {args.triplet, host_triplet})
+        if reason:
+            print(f'{reason}, all ports are affected', file=sys.stderr)
+    ci_baseline = load_ci_baseline(args.ci_baseline)
+    ports = {port_name for port_name, (state, _) in compute_impacted(graph, changed_ports, ci_baseline).items()
+             if state == 'build'}
+    host_ports = ports
+    if host_triplet != args.triplet:
+        host_graph = PortGraph(manifests, host_triplet, host_triplet)
+        host_ports = {port_name for port_name, (state, _) in compute_impacted(host_graph, changed_ports, ci_baseline).items()
+                      if state == 'build'}
+    return Schedule(graph, ports, host_ports, Durations(load_history(args.history)))
+
+
+def format_duration(seconds):
+    return f'{int(seconds // 3600)}h{int(seconds % 3600 // 60):02d}m' if seconds >= 3600 else f'{seconds / 60:.1f}m'
+
+
+def plan(args):
+    schedule = build_schedule(args)
+    if args.agent_index is not None:
+        # The ports this agent must not build, for `vcpkg ci --exclude`.
+        agent_tasks, _ = schedule.partition(args.agent_count, True)
+        mine = agent_tasks[args.agent_index]
+        excluded = sorted(port_name for port_name, triplet in schedule.tasks
+                          if triplet == args.triplet and (port_name, triplet) not in mine)
+        if args.exclude_file:
+            # A vcpkg response file with one argument per line; thousands of names exceed the
+            # command line length limit of Windows.
+            os.makedirs(os.path.dirname(os.path.abspath(args.exclude_file)), exist_ok=True)
+            with open(args.exclude_file, 'w') as exclude_file:
+                if excluded:
+                    exclude_file.write(f'--exclude={",".join(excluded)}\n')
+            print(f'Agent {args.agent_index} of {args.agent_count}: {len(mine)} builds, {len(excluded)} ports excluded')
+        else:
+            print(','.join(excluded))
+        return
+    print(f'{len(schedule.tasks)} builds, {format_duration(schedule.total())} in total')
+    print('Critical path:')
+    for task in schedule.critical_path():
+        print(f'  {task[0]}:{task[1]} {format_duration(schedule.durations[task])}')
+    print(f'  = {format_duration(max(schedule.rank.values(), default=0.0))}')
+    agent_tasks, loads = schedule.partition(args.agent_count, True)
+    for agent, (tasks, load) in enumerate(zip(agent_tasks, loads)):
+        print(f'Agent {agent}: {len(tasks)} builds, {format_duration(load)}')
+
+
+def simulate(args):
+    schedule = build_schedule(args)
+    if not schedule.tasks:
+        print('Nothing to build')
+        return
+    lower_bound = max(max(schedule.rank.values()), schedule.total() / args.agent_count)
+    position = {task: index for index, task in enumerate(schedule.order)}
+    results = [
+        ('shared queue, dependency order', schedule.simulate_shared_queue(
+            args.agent_count, lambda task: position[task], args.restore_seconds)),
+        ('shared queue, critical path first', schedule.simulate_shared_queue(
+            args.agent_count, lambda task: (-schedule.rank[task], task), args.restore_seconds)),
+        ('partition, by name', max(schedule.partition(args.agent_count, False)[1])),
+        ('partition, by cost', max(schedule.partition(args.agent_count, True)[1])),
+    ]
+    print(f'{len(schedule.tasks)} builds on {args.agent_count} agents, {format_duration(schedule.total())} in total, '
+          f'lower bound {format_duration(lower_bound)}')
+    for name, makespan in results:
+        print(f'  {name:<36} {format_duration(makespan):>8} ({makespan / lower_bound:.2f}x lower bound)')
+
+
+def record(args):
+    history = load_history(args.history)
+    measured = read_xunit_durations(args.xunit)
+    for task, seconds in measured.items():
+        history[task] = seconds if task not in history else \
+            RECORD_WEIGHT * seconds + (1 - RECORD_WEIGHT) * history[task]
+    write_history(args.history, history)
+    print(f'Recorded {len(measured)} durations in {args.history}')
+
+
+def synthesize(args):
+    # A stand-in for recorded history: log-normal durations with the well-known giants on top.
+    random.seed(args.seed)
+    history = {}
+    for port_name in sorted(load_manifests()):
+        history[(port_name, args.triplet)] = round(random.lognormvariate(4.0, 1.2))
+    for port_name, seconds in (('llvm', 14400), ('qtwebengine', 12600), ('opencv4', 3600), ('vtk', 5400),
+                               ('paraview', 4800), ('qtbase', 2400), ('boost-math', 900), ('ffmpeg', 1800)):
+        if (port_name, args.triplet) in history:
+            history[(port_name, args.triplet)] = seconds
+    write_history(args.history, history)
+    print(f'Wrote {len(history)} synthetic durations to {args.history}')
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Schedule CI port builds by their recorded durations and the port dependency graph.')
+    parser.add_argument('--history', help='Durations file with port:triplet=seconds lines.')
+    subparsers = parser.add_subparsers(dest='command', required=True)
+    for name, help_text in (('plan', 'Print the critical path and the partition across agents.'),
+                            ('simulate', 'Compare the makespans of scheduling strategies.')):
+        command_parser = subparsers.add_parser(name, help=help_text)
+        command_parser.add_argument('files', nargs='*', help='Changed files relative to the vcpkg root.')
+        command_parser.add_argument('--since', help='Use the files changed since this git revision.')
+        command_parser.add_argument('--all', action='store_true', help='Schedule every port, as a full rebuild does.')
+        command_parser.add_argument('--triplet', required=True)
+        command_parser.add_argument('--host-triplet')
+        command_parser.add_argument('--ci-baseline', default=CI_BASELINE_PATH)
+        command_parser.add_argument('--agent-count', type=int, default=1)
+    subparsers.choices['plan'].add_argument(
+        '--agent-index', type=int, help='Print the ports this agent excludes, comma separated.')
+    subparsers.choices['plan'].add_argument(
+        '--exclude-file', help='With --agent-index, write the excluded ports to this vcpkg response file instead.')
+    subparsers.choices['simulate'].add_argument(
+        '--restore-seconds', type=float, default=10.0, help='Cost of restoring a dependency built on another agent.')
+    record_parser = subparsers.add_parser('record', help='Add the durations of an xunit file to the history.')
+    record_parser.add_argument('--xunit', required=True)
+    synthesize_parser = subparsers.add_parser('synthesize', help='Write a synthetic history to try the scheduler.')
+    synthesize_parser.add_argument('--triplet', required=True)
+    synthesize_parser.add_argument('--seed', type=int, default=0)
+    args = parser.parse_args()
+
+    if args.command in ('record', 'synthesize') and not args.history:
+        parser.error(f'{args.command} requires --history')
+    if getattr(args, 'agent_index', None) is not None and not 0 <= args.agent_index < args.agent_count:
+        parser.error('--agent-index must be less than --agent-count')
+    if getattr(args, 'exclude_file', None) and getattr(args, 'agent_index', None) is None:
+        parser.error('--exclude-file requires --agent-index')
+    {'plan': plan, 'simulate': simulate, 'record': record, 'synthesize': synthesize}[args.command](args)
+
+
+if __name__ == "__main__":
+    main()
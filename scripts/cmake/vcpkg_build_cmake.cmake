@@ -5,6 +5,8 @@ function(vcpkg_build_cmake)
         ""
     )
 
+    z_vcpkg_adaptive_concurrency(vcpkg_build_cmake)
+
     if(Z_VCPKG_CMAKE_BUILD_GUARD)
         message(FATAL_ERROR "The ${PORT} port already depends on vcpkg-cmake; using both vcpkg-cmake and vcpkg_build_cmake in the same port is unsupported.")
     endif()
@@ -13,6 +13,8 @@ function(vcpkg_build_make)
         message(WARNING "vcpkg_make_build was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
     endif()
 
+    z_vcpkg_adaptive_concurrency(vcpkg_build_make)
+
     if(NOT DEFINED arg_LOGFILE_ROOT)
         set(arg_LOGFILE_ROOT "build")
     endif()
@@ -1,7 +1,11 @@
 function(z_vcpkg_build_ninja_build config targets)
     message(STATUS "Building (${config})...")
+    set(parallel_param "")
+    if(Z_VCPKG_ADAPTIVE_CONCURRENCY)
+        set(parallel_param "-j${VCPKG_CONCURRENCY}")
+    endif()
     vcpkg_execute_build_process(
-        COMMAND "${NINJA}" -C "${CURRENT_BUILDTREES_DIR}/${config}" ${targets}
+        COMMAND "${NINJA}" -C "${CURRENT_BUILDTREES_DIR}/${config}" ${parallel_param} ${targets}
         WORKING_DIRECTORY "${SOURCE_PATH}"
         LOGNAME "build-${config}"
     )
@@ -14,6 +18,9 @@ function(vcpkg_build_ninja)
     if(DEFINED arg_UNPARSED_ARGUMENTS)
         message(WARNING "${CMAKE_CURRENT_FUNCTION} was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
     endif()
+
+    z_vcpkg_adaptive_concurrency(vcpkg_build_ninja)
+
     if(NOT DEFINED arg_TARGETS)
         set(arg_TARGETS "")
     endif()
@@ -7,6 +7,9 @@ function(vcpkg_build_nmake)
     if(DEFINED arg_UNPARSED_ARGUMENTS)
         message(WARNING "${CMAKE_CURRENT_FUNCTION} was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
     endif()
+
+    z_vcpkg_adaptive_concurrency(vcpkg_build_nmake)
+
     if(NOT DEFINED arg_SOURCE_PATH)
         message(FATAL_ERROR "SOURCE_PATH must be specified")
     endif()
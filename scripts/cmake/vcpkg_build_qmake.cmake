@@ -16,6 +16,8 @@ function(vcpkg_build_qmake)
         "TARGETS;RELEASE_TARGETS;DEBUG_TARGETS"
     )
 
+    z_vcpkg_adaptive_concurrency(vcpkg_build_qmake)
+
     # Make sure that the linker finds the libraries used
     vcpkg_backup_env_variables(VARS PATH LD_LIBRARY_PATH CL _CL_)
 
@@ -17,6 +17,67 @@ set(Z_VCPKG_EXECUTE_BUILD_PROCESS_RETRY_ERROR_MESSAGES
 )
 list(JOIN Z_VCPKG_EXECUTE_BUILD_PROCESS_RETRY_ERROR_MESSAGES "|" Z_VCPKG_EXECUTE_BUILD_PROCESS_RETRY_ERROR_MESSAGES)
 
+# Logs are scanned in chunks of this size, so that verbose logs are never held in memory at once.
+set(Z_VCPKG_EXECUTE_BUILD_PROCESS_LOG_CHUNK_SIZE 1048576)
+
+# Sets `out_var` to the first match of `regex` in the given logs, or to "" if there is none.
+# Each log is read backwards from its end, where build failures are reported. Chunks overlap
+# so that single line messages are never split.
+function(z_vcpkg_execute_build_process_match_logs out_var regex)
+    set(chunk_size "${Z_VCPKG_EXECUTE_BUILD_PROCESS_LOG_CHUNK_SIZE}")
+    math(EXPR read_size "${chunk_size} + 4096")
+    foreach(log IN LISTS ARGN)
+        if(NOT EXISTS "${log}")
+            continue()
+        endif()
+        file(SIZE "${log}" offset)
+        while(offset GREATER "0")
+            math(EXPR offset "${offset} - ${chunk_size}")
+            if(offset LESS "0")
+                set(offset 0)
+            endif()
+            file(READ "${log}" contents OFFSET "${offset}" LIMIT "${read_size}")
+            if(contents MATCHES "${regex}")
+                set("${out_var}" "${CMAKE_MATCH_0}" PARENT_SCOPE)
+                return()
+            endif()
+        endwhile()
+    endforeach()
+    set("${out_var}" "" PARENT_SCOPE)
+endfunction()
+
+# Rewrites the job count of a parallel build command (-jN, -j N, -jobs N, /m) to `jobs`.
+# `out_found` is set to OFF if the command has no recognizable job count.
+function(z_vcpkg_execute_build_process_set_jobs out_var out_found jobs)
+    cmake_parse_arguments(PARSE_ARGV 3 arg "" "" "COMMAND")
+    set(found OFF)
+    set(replace_next OFF)
+    vcpkg_list(SET command)
+    foreach(item IN LISTS arg_COMMAND)
+        if(replace_next AND item STREQUAL "${VCPKG_CONCURRENCY}")
+            set(item "${jobs}")
+            set(found ON)
+        elseif(item STREQUAL "-j${VCPKG_CONCURRENCY}")
+            set(item "-j${jobs}")
+            set(found ON)
+        elseif(item STREQUAL "/m")
+            set(item "/m:${jobs}")
+            set(found ON)
+        elseif(item MATCHES "(^| )-j ?${VCPKG_CONCURRENCY}( |\$)")
+            # A command line passed through a shell as one argument
+            string(REGEX REPLACE "(^| )-j ?${VCPKG_CONCURRENCY}( |\$)" "\\1-j${jobs}\\2" item "${item}")
+            set(found ON)
+        endif()
+        set(replace_next OFF)
+        if(item STREQUAL "-j" OR item STREQUAL "-jobs")
+            set(replace_next ON)
+        endif()
+        vcpkg_list(APPEND command "${item}")
+    endforeach()
+    set("${out_var}" "${command}" PARENT_SCOPE)
+    set("${out_found}" "${found}" PARENT_SCOPE)
+endfunction()
+
 function(vcpkg_execute_build_process)
     cmake_parse_arguments(PARSE_ARGV 0 arg "" "WORKING_DIRECTORY;LOGNAME" "COMMAND;NO_PARALLEL_COMMAND")
 
@@ -45,6 +106,10 @@ function(vcpkg_execute_build_process)
             vcpkg_list(PREPEND arg_NO_PARALLEL_COMMAND "${CMAKE_COMMAND}" "-E" "time")
         endif()
     endif()
+    z_vcpkg_resource_usage_wrap(arg_COMMAND "${arg_LOGNAME}")
+    if(DEFINED arg_NO_PARALLEL_COMMAND)
+        z_vcpkg_resource_usage_wrap(arg_NO_PARALLEL_COMMAND "${arg_LOGNAME}")
+    endif()
 
     execute_process(
         COMMAND ${arg_COMMAND}
@@ -58,26 +123,86 @@ function(vcpkg_execute_build_process)
         message(FATAL_ERROR "Failed to execute command \"${command}\" in working directory \"${arg_WORKING_DIRECTORY}\": ${error_code}")
     endif()
     if(NOT error_code EQUAL "0")
-        file(READ "${log_out}" out_contents)
-        file(READ "${log_err}" err_contents)
-        set(all_contents "${out_contents}${err_contents}")
-        if(all_contents MATCHES "${Z_VCPKG_EXECUTE_BUILD_PROCESS_RETRY_ERROR_MESSAGES}")
+        set(mt_error_message "mt(\\.exe)? : general error c101008d: ")
+        z_vcpkg_execute_build_process_match_logs(error_message
+            "${Z_VCPKG_EXECUTE_BUILD_PROCESS_RETRY_ERROR_MESSAGES}|${mt_error_message}"
+            "${log_err}" "${log_out}"
+        )
+        if(error_message STREQUAL "")
+            # Not a known transient error, fall through to the failure report
+        elseif(Z_VCPKG_EXECUTE_BUILD_PROCESS_NO_RETRY)
+            # The caller needs the outcome of the first attempt, e.g. the DISABLE_PARALLEL audit
+            message(STATUS "Not restarting the build after a transient error: ${error_message}")
+        elseif(NOT error_message MATCHES "^${mt_error_message}\$")
             message(WARNING "Please ensure your system has sufficient memory.")
-            set(log_out "${log_prefix}-out-1.log")
-            set(log_err "${log_prefix}-err-1.log")
-            list(APPEND all_logs "${log_out}" "${log_err}")
-
             if(DEFINED arg_NO_PARALLEL_COMMAND)
-                message(STATUS "Restarting build without parallelism")
-                execute_process(
-                    COMMAND ${arg_NO_PARALLEL_COMMAND}
-                    WORKING_DIRECTORY "${arg_WORKING_DIRECTORY}"
-                    OUTPUT_FILE "${log_out}"
-                    ERROR_FILE "${log_err}"
-                    RESULT_VARIABLE error_code
-                )
+                # Halve the job count on every attempt. Ninja and make keep the work which
+                # completed before, so each attempt only continues the build.
+                set(min_jobs 1)
+                if(DEFINED VCPKG_RETRY_MIN_CONCURRENCY)
+                    set(min_jobs "${VCPKG_RETRY_MIN_CONCURRENCY}")
+                endif()
+                if(min_jobs GREATER VCPKG_CONCURRENCY)
+                    set(min_jobs "${VCPKG_CONCURRENCY}")
+                endif()
+                set(log_attempts "${log_prefix}-attempts.log")
+                list(APPEND all_logs "${log_attempts}")
+                file(WRITE "${log_attempts}" "attempt 0: jobs=${VCPKG_CONCURRENCY}, exit code ${error_code}\n")
+                set(jobs "${VCPKG_CONCURRENCY}")
+                set(attempt 1)
+                while(1)
+                    math(EXPR jobs "${jobs} / 2")
+                    if(jobs LESS min_jobs)
+                        set(jobs "${min_jobs}")
+                    endif()
+                    set(command "")
+                    set(found OFF)
+                    if(jobs GREATER "1")
+                        z_vcpkg_execute_build_process_set_jobs(command found "${jobs}" COMMAND ${arg_COMMAND})
+                    endif()
+                    if(NOT found)
+                        set(jobs 1)
+                        set(command ${arg_NO_PARALLEL_COMMAND})
+                    endif()
+
+                    cmake_host_system_information(RESULT memory QUERY AVAILABLE_PHYSICAL_MEMORY TOTAL_PHYSICAL_MEMORY)
+                    list(GET memory 0 available_memory)
+                    list(GET memory 1 total_memory)
+                    set(attempt_message "attempt ${attempt}: jobs=${jobs}, available memory ${available_memory} MiB of ${total_memory} MiB")
+                    if(jobs EQUAL "1")
+                        message(STATUS "Restarting build without parallelism (${attempt_message})")
+                    else()
+                        message(STATUS "Restarting build with reduced parallelism (${attempt_message})")
+                    endif()
+
+                    set(log_out "${log_prefix}-out-${attempt}.log")
+                    set(log_err "${log_prefix}-err-${attempt}.log")
+                    list(APPEND all_logs "${log_out}" "${log_err}")
+                    execute_process(
+                        COMMAND ${command}
+                        WORKING_DIRECTORY "${arg_WORKING_DIRECTORY}"
+                        OUTPUT_FILE "${log_out}"
+                        ERROR_FILE "${log_err}"
+                        RESULT_VARIABLE error_code
+                    )
+                    file(APPEND "${log_attempts}" "${attempt_message}, exit code ${error_code}\n")
+                    if(error_code EQUAL "0" OR jobs LESS_EQUAL min_jobs OR jobs EQUAL "1")
+                        break()
+                    endif()
+                    z_vcpkg_execute_build_process_match_logs(error_message
+                        "${Z_VCPKG_EXECUTE_BUILD_PROCESS_RETRY_ERROR_MESSAGES}"
+                        "${log_err}" "${log_out}"
+                    )
+                    if(error_message STREQUAL "")
+                        break()
+                    endif()
+                    math(EXPR attempt "${attempt} + 1")
+                endwhile()
             else()
                 message(STATUS "Restarting build")
+                set(log_out "${log_prefix}-out-1.log")
+                set(log_err "${log_prefix}-err-1.log")
+                list(APPEND all_logs "${log_out}" "${log_err}")
                 execute_process(
                     COMMAND ${arg_COMMAND}
                     WORKING_DIRECTORY "${arg_WORKING_DIRECTORY}"
@@ -86,7 +211,7 @@ function(vcpkg_execute_build_process)
                     RESULT_VARIABLE error_code
                 )
             endif()
-        elseif(all_contents MATCHES "mt(\\.exe)? : general error c101008d: ")
+        else()
             # Antivirus workaround - occasionally files are locked and cause mt.exe to fail
             message(STATUS "mt.exe has failed. This may be the result of anti-virus. Disabling anti-virus on the buildtree folder may improve build speed")
             foreach(iteration RANGE 1 3)
@@ -107,10 +232,8 @@ function(vcpkg_execute_build_process)
                     break()
                 endif()
 
-                file(READ "${log_out}" out_contents)
-                file(READ "${log_err}" err_contents)
-                set(all_contents "${out_contents}${err_contents}")
-                if(NOT all_contents MATCHES "mt : general error c101008d: ")
+                z_vcpkg_execute_build_process_match_logs(error_message "mt : general error c101008d: " "${log_err}" "${log_out}")
+                if(error_message STREQUAL "")
                     break()
                 endif()
             endforeach()
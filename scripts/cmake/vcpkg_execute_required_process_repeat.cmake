@@ -30,6 +30,9 @@ Halting portfile execution.
     if(X_PORT_PROFILE AND NOT arg_ALLOW_IN_DOWNLOAD_MODE)
         vcpkg_list(PREPEND arg_COMMAND "${CMAKE_COMMAND}" "-E" "time")
     endif()
+    if(NOT arg_ALLOW_IN_DOWNLOAD_MODE)
+        z_vcpkg_resource_usage_wrap(arg_COMMAND "${arg_LOGNAME}")
+    endif()
 
     set(all_logs "")
     foreach(loop_count RANGE 1 ${arg_COUNT})
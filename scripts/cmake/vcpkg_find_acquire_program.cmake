@@ -1,7 +1,7 @@
 function(z_vcpkg_find_acquire_program_version_check out_var)
     cmake_parse_arguments(PARSE_ARGV 1 arg
         "EXACT_VERSION_MATCH"
-        "MIN_VERSION;PROGRAM_NAME"
+        "MIN_VERSION;PROGRAM_NAME;OUT_VERSION"
         "COMMAND"
     )
     vcpkg_execute_in_download_mode(
@@ -24,6 +24,37 @@ function(z_vcpkg_find_acquire_program_version_check out_var)
         message(STATUS "Found external ${arg_PROGRAM_NAME}('${program_version_output}').")
         set("${out_var}" ON PARENT_SCOPE)
     endif()
+    if(DEFINED arg_OUT_VERSION)
+        set("${arg_OUT_VERSION}" "${program_version_output}" PARENT_SCOPE)
+    endif()
+endfunction()
+
+# Describes the files referenced by a program command line (executable, script) by
+# resolved path, size and timestamp. A changed description invalidates cached results.
+function(z_vcpkg_find_acquire_program_cache_stamp out_var)
+    set(stamp "")
+    foreach(item IN LISTS ARGN)
+        if(IS_ABSOLUTE "${item}" AND EXISTS "${item}" AND NOT IS_DIRECTORY "${item}")
+            file(REAL_PATH "${item}" real_path)
+            file(SIZE "${real_path}" size)
+            file(TIMESTAMP "${real_path}" timestamp "%Y-%m-%dT%H:%M:%S.%f" UTC)
+            string(APPEND stamp "${item}|${real_path}|${size}|${timestamp}\n")
+        endif()
+    endforeach()
+    set("${out_var}" "${stamp}" PARENT_SCOPE)
+endfunction()
+
+# The discovery cache is shared by all port builds on the host. Entries are keyed by the search
+# inputs (including PATH) and are only used while the search finds the same program with the same stamp.
+function(z_vcpkg_find_acquire_program_cache_file out_var program)
+    set("${out_var}" "" PARENT_SCOPE)
+    if(NOT DEFINED DOWNLOADS OR VCPKG_FIND_ACQUIRE_PROGRAM_NO_CACHE)
+        return()
+    endif()
+    string(JOIN "\n" key_data "${program}" ${ARGN} "$ENV{PATH}")
+    string(SHA512 key "${key_data}")
+    string(SUBSTRING "${key}" 0 16 key)
+    set("${out_var}" "${DOWNLOADS}/tools/vcpkg-find-acquire-program-cache/${program}-${key}.cmake" PARENT_SCOPE)
 endfunction()
 
 function(z_vcpkg_find_acquire_program_find_external program)
@@ -36,6 +67,10 @@ function(z_vcpkg_find_acquire_program_find_external program)
         set(arg_EXACT_VERSION_MATCH EXACT_VERSION_MATCH)
     endif()
 
+    z_vcpkg_find_acquire_program_cache_file(cache_file "${program}"
+        "${arg_PROGRAM_NAME}" "${arg_MIN_VERSION}" "${arg_EXACT_VERSION_MATCH}" "${version_command}"
+        "${arg_INTERPRETER}" "${${arg_INTERPRETER}}" ${arg_NAMES}
+    )
     if("${arg_INTERPRETER}" STREQUAL "")
         find_program("${program}" NAMES ${arg_NAMES})
     else()
@@ -50,6 +85,30 @@ function(z_vcpkg_find_acquire_program_find_external program)
     endif()
 
     set(${program} "$CACHE{${program}}")
+    # The search itself is cheap and always runs: a cached verdict only applies to the very program
+    # the search finds now, so a tool which appeared earlier on PATH (or replaced the found one)
+    # invalidates the entry, including a negative one.
+    if(NOT "${cache_file}" STREQUAL "" AND EXISTS "${cache_file}")
+        include("${cache_file}")
+        z_vcpkg_find_acquire_program_cache_stamp(current_stamp ${${program}})
+        if(NOT "${current_stamp}" STREQUAL "" AND "${${program}}" STREQUAL "${z_cached_program}"
+                AND "${current_stamp}" STREQUAL "${z_cached_stamp}")
+            if(z_cached_version_is_good)
+                if(NOT "${z_cached_version}" STREQUAL "")
+                    message(STATUS "Found external ${arg_PROGRAM_NAME}('${z_cached_version}') (cached).")
+                endif()
+                set("${program}" "${z_cached_program}" PARENT_SCOPE)
+            else()
+                message(STATUS "Found ${arg_PROGRAM_NAME}('${z_cached_version}') but version ${arg_MIN_VERSION} is required (cached). Trying to use internal version if possible!")
+                set("${program}" "${program}-NOTFOUND" PARENT_SCOPE)
+                unset("${program}" CACHE)
+            endif()
+            return()
+        endif()
+        file(REMOVE "${cache_file}")
+    endif()
+
+    set(program_version_output "")
     if("${version_command}" STREQUAL "")
         set(version_is_good ON) # can't check for the version being good, so assume it is
     elseif(${program}) # only do a version check if ${program} has a value
@@ -58,9 +117,26 @@ function(z_vcpkg_find_acquire_program_find_external program)
             COMMAND ${${program}} ${arg_VERSION_COMMAND}
             MIN_VERSION "${arg_MIN_VERSION}"
             PROGRAM_NAME "${arg_PROGRAM_NAME}"
+            OUT_VERSION program_version_output
         )
     endif()
 
+    if(${program} AND NOT "${cache_file}" STREQUAL "")
+        z_vcpkg_find_acquire_program_cache_stamp(stamp ${${program}})
+        if(NOT "${stamp}" STREQUAL "")
+            if(NOT version_is_good)
+                set(version_is_good OFF)
+            endif()
+            string(RANDOM LENGTH 8 suffix)
+            file(WRITE "${cache_file}.${suffix}.tmp" "set(z_cached_program [==[${${program}}]==])
+set(z_cached_stamp [==[${stamp}]==])
+set(z_cached_version [==[${program_version_output}]==])
+set(z_cached_version_is_good ${version_is_good})
+")
+            file(RENAME "${cache_file}.${suffix}.tmp" "${cache_file}")
+        endif()
+    endif()
+
     if(version_is_good)
         set(${program} "$CACHE{${program}}" PARENT_SCOPE)
     else()
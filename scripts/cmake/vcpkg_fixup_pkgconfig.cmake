@@ -112,17 +112,24 @@ function(z_vcpkg_fixup_pkgconfig_process_data arg_variable arg_config arg_prefix
     set("${arg_variable}" "${contents}" PARENT_SCOPE)
 endfunction()
 
-function(z_vcpkg_fixup_pkgconfig_check_files arg_file arg_config)
-    set(path_suffix_DEBUG /debug)
-    set(path_suffix_RELEASE "")
+# Validates all packages of one config with a single pkg-config invocation.
+# Only if that fails, the packages are checked one by one to name the culprit.
+function(z_vcpkg_fixup_pkgconfig_check_files arg_config)
+    set(package_names "")
+    foreach(file IN LISTS ARGN)
+        cmake_path(GET file STEM LAST_ONLY package_name)
+        list(APPEND package_names "${package_name}")
+    endforeach()
+    if(package_names STREQUAL "")
+        return()
+    endif()
 
     z_vcpkg_setup_pkgconfig_path(CONFIG "${arg_config}")
 
-    # First make sure everything is ok with the package and its deps
-    cmake_path(GET arg_file STEM LAST_ONLY package_name)
-    debug_message("Checking package (${arg_config}): ${package_name}")
+    # First make sure everything is ok with the packages and their deps
+    debug_message("Checking packages (${arg_config}): ${package_names}")
     execute_process(
-        COMMAND "${PKGCONFIG}" --print-errors --exists "${package_name}"
+        COMMAND "${PKGCONFIG}" --print-errors --exists ${package_names}
         WORKING_DIRECTORY "${CURRENT_BUILDTREES_DIR}"
         RESULT_VARIABLE error_var
         OUTPUT_VARIABLE output
@@ -130,16 +137,37 @@ function(z_vcpkg_fixup_pkgconfig_check_files arg_file arg_config)
         OUTPUT_STRIP_TRAILING_WHITESPACE
         ERROR_STRIP_TRAILING_WHITESPACE
     )
-    if(NOT "${error_var}" EQUAL "0")
-        message(FATAL_ERROR "${PKGCONFIG} --exists ${package_name} failed with error code: ${error_var}
-    ENV{PKG_CONFIG_PATH}: \"$ENV{PKG_CONFIG_PATH}\"
-    output: ${output}"
-        )
-    else()
-        debug_message("pkg-config --exists ${package_name} output: ${output}")
+    if("${error_var}" EQUAL "0")
+        debug_message("pkg-config --exists ${package_names} output: ${output}")
+        z_vcpkg_restore_pkgconfig_path()
+        return()
     endif()
 
-    z_vcpkg_restore_pkgconfig_path()
+    list(LENGTH package_names package_count)
+    foreach(package_name IN LISTS package_names)
+        if(package_count GREATER "1")
+            execute_process(
+                COMMAND "${PKGCONFIG}" --print-errors --exists "${package_name}"
+                WORKING_DIRECTORY "${CURRENT_BUILDTREES_DIR}"
+                RESULT_VARIABLE error_var
+                OUTPUT_VARIABLE output
+                ERROR_VARIABLE  output
+                OUTPUT_STRIP_TRAILING_WHITESPACE
+                ERROR_STRIP_TRAILING_WHITESPACE
+            )
+        endif()
+        if(NOT "${error_var}" EQUAL "0")
+            message(FATAL_ERROR "${PKGCONFIG} --exists ${package_name} failed with error code: ${error_var}
+    ENV{PKG_CONFIG_PATH}: \"$ENV{PKG_CONFIG_PATH}\"
+    output: ${output}"
+            )
+        endif()
+    endforeach()
+    # Each package passed on its own, so the combination is at fault.
+    message(FATAL_ERROR "${PKGCONFIG} --exists ${package_names} failed with error code: ${error_var}
+    ENV{PKG_CONFIG_PATH}: \"$ENV{PKG_CONFIG_PATH}\"
+    output: ${output}"
+    )
 endfunction()
 
 function(vcpkg_fixup_pkgconfig)
@@ -184,17 +212,18 @@ function(vcpkg_fixup_pkgconfig)
                 cmake_path(RELATIVE_PATH relative_pc_path BASE_DIRECTORY "${pkg_lib_search_path}")
             endif()
             #Correct *.pc file
-            file(READ "${file}" contents)
+            file(READ "${file}" original_contents)
+            set(contents "${original_contents}")
             z_vcpkg_fixup_pkgconfig_process_data(contents "${config}" "\${pcfiledir}/${relative_pc_path}")
-            file(WRITE "${file}" "${contents}")
+            if(NOT contents STREQUAL original_contents)
+                file(WRITE "${file}" "${contents}")
+            endif()
         endforeach()
 
         if(NOT arg_SKIP_CHECK) # The check can only run after all files have been corrected!
             vcpkg_find_acquire_program(PKGCONFIG)
             debug_message("Using pkg-config from: ${PKGCONFIG}")
-            foreach(file IN LISTS "arg_${config}_FILES")
-                z_vcpkg_fixup_pkgconfig_check_files("${file}" "${config}")
-            endforeach()
+            z_vcpkg_fixup_pkgconfig_check_files("${config}" ${arg_${config}_FILES})
         endif()
     endforeach()
     debug_message("Fixing pkgconfig --- finished")
@@ -0,0 +1,124 @@
+include_guard(GLOBAL)
+
+# Installs a header-only library without configuring or building it, so no compiler is detected.
+#
+# vcpkg_install_header_only(
+#     SOURCE_PATH <path>
+#     [HEADERS <dir-or-file>...]            # relative to SOURCE_PATH, default "include"
+#     [INCLUDE_SUBDIR <dir>]                # destination below include/
+#     [PATTERNS <glob>...]                  # only install matching files from directories
+#     [CONFIG_FILES <file>...]              # installed to share/<PACKAGE_NAME> after @ONLY substitution
+#     [TARGET <namespace::name>]            # generates <PACKAGE_NAME>Config.cmake with an INTERFACE target
+#     [PACKAGE_NAME <name>]                 # default ${PORT}
+#     [VERSION <version>] [COMPATIBILITY <mode>]
+#     [DEPENDENCIES <package>...]           # find_dependency() calls of the generated config
+#     [LINK_LIBRARIES <target>...]
+#     [COMPILE_DEFINITIONS <definition>...]
+#     [COMPILE_FEATURES <feature>...]
+#     [USAGE <file>]                        # default ${CURRENT_PORT_DIR}/usage, generated for TARGET
+# )
+function(vcpkg_install_header_only)
+    cmake_parse_arguments(PARSE_ARGV 0 arg
+        ""
+        "SOURCE_PATH;INCLUDE_SUBDIR;TARGET;PACKAGE_NAME;VERSION;COMPATIBILITY;USAGE"
+        "HEADERS;PATTERNS;CONFIG_FILES;DEPENDENCIES;LINK_LIBRARIES;COMPILE_DEFINITIONS;COMPILE_FEATURES"
+    )
+    if(DEFINED arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "${CMAKE_CURRENT_FUNCTION} was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+    if(NOT DEFINED arg_SOURCE_PATH)
+        message(FATAL_ERROR "SOURCE_PATH must be specified")
+    endif()
+    if(NOT DEFINED arg_HEADERS)
+        set(arg_HEADERS include)
+    endif()
+    if(NOT DEFINED arg_PACKAGE_NAME)
+        set(arg_PACKAGE_NAME "${PORT}")
+    endif()
+    if(NOT DEFINED arg_VERSION)
+        string(REGEX MATCH "^[0-9]+(\\.[0-9]+)*" arg_VERSION "${VERSION}")
+    endif()
+    if(NOT DEFINED arg_COMPATIBILITY)
+        set(arg_COMPATIBILITY SameMajorVersion)
+    endif()
+    if(NOT DEFINED arg_TARGET)
+        foreach(option IN ITEMS DEPENDENCIES LINK_LIBRARIES COMPILE_DEFINITIONS COMPILE_FEATURES)
+            if(DEFINED arg_${option})
+                message(FATAL_ERROR "${option} requires TARGET")
+            endif()
+        endforeach()
+    endif()
+
+    set(include_dir "${CURRENT_PACKAGES_DIR}/include")
+    if(DEFINED arg_INCLUDE_SUBDIR)
+        string(APPEND include_dir "/${arg_INCLUDE_SUBDIR}")
+    endif()
+    set(files_matching "")
+    if(DEFINED arg_PATTERNS)
+        set(files_matching FILES_MATCHING)
+        foreach(pattern IN LISTS arg_PATTERNS)
+            list(APPEND files_matching PATTERN "${pattern}")
+        endforeach()
+    endif()
+    foreach(header IN LISTS arg_HEADERS)
+        set(header_path "${arg_SOURCE_PATH}/${header}")
+        if(IS_DIRECTORY "${header_path}")
+            file(INSTALL "${header_path}/" DESTINATION "${include_dir}" ${files_matching})
+        elseif(EXISTS "${header_path}")
+            file(INSTALL "${header_path}" DESTINATION "${include_dir}")
+        else()
+            message(FATAL_ERROR "${CMAKE_CURRENT_FUNCTION} was passed a non-existing path: ${header_path}")
+        endif()
+    endforeach()
+
+    set(share_dir "${CURRENT_PACKAGES_DIR}/share/${arg_PACKAGE_NAME}")
+    foreach(config_file IN LISTS arg_CONFIG_FILES)
+        get_filename_component(config_name "${config_file}" NAME)
+        string(REGEX REPLACE "\\.in\$" "" config_name "${config_name}")
+        configure_file("${config_file}" "${share_dir}/${config_name}" @ONLY)
+    endforeach()
+
+    if(DEFINED arg_TARGET)
+        set(config_contents "include(CMakeFindDependencyMacro)\n")
+        foreach(dependency IN LISTS arg_DEPENDENCIES)
+            string(APPEND config_contents "find_dependency(${dependency} CONFIG)\n")
+        endforeach()
+        string(APPEND config_contents "
+if(NOT TARGET ${arg_TARGET})
+    get_filename_component(z_vcpkg_prefix \"\${CMAKE_CURRENT_LIST_DIR}/../..\" ABSOLUTE)
+    add_library(${arg_TARGET} INTERFACE IMPORTED)
+    set_target_properties(${arg_TARGET} PROPERTIES
+        INTERFACE_INCLUDE_DIRECTORIES \"\${z_vcpkg_prefix}/include\"
+")
+        foreach(property IN ITEMS LINK_LIBRARIES COMPILE_DEFINITIONS COMPILE_FEATURES)
+            if(NOT "${arg_${property}}" STREQUAL "")
+                string(APPEND config_contents "        INTERFACE_${property} \"${arg_${property}}\"\n")
+            endif()
+        endforeach()
+        string(APPEND config_contents "    )\n    unset(z_vcpkg_prefix)\nendif()\n")
+        file(WRITE "${share_dir}/${arg_PACKAGE_NAME}Config.cmake" "${config_contents}")
+
+        if(NOT arg_VERSION STREQUAL "")
+            include(CMakePackageConfigHelpers)
+            write_basic_package_version_file("${share_dir}/${arg_PACKAGE_NAME}ConfigVersion.cmake"
+                VERSION "${arg_VERSION}"
+                COMPATIBILITY "${arg_COMPATIBILITY}"
+                ARCH_INDEPENDENT
+            )
+        endif()
+    endif()
+
+    if(NOT DEFINED arg_USAGE AND EXISTS "${CURRENT_PORT_DIR}/usage")
+        set(arg_USAGE "${CURRENT_PORT_DIR}/usage")
+    endif()
+    if(DEFINED arg_USAGE)
+        file(INSTALL "${arg_USAGE}" DESTINATION "${CURRENT_PACKAGES_DIR}/share/${PORT}" RENAME usage)
+    elseif(DEFINED arg_TARGET)
+        file(WRITE "${CURRENT_PACKAGES_DIR}/share/${PORT}/usage" "\
+${PORT} is header-only and provides CMake targets:
+
+    find_package(${arg_PACKAGE_NAME} CONFIG REQUIRED)
+    target_link_libraries(main PRIVATE ${arg_TARGET})
+")
+    endif()
+endfunction()
@@ -11,6 +11,8 @@ function(vcpkg_install_msbuild)
         message(WARNING "vcpkg_install_msbuild was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
     endif()
 
+    z_vcpkg_adaptive_concurrency(vcpkg_install_msbuild)
+
     if(NOT DEFINED arg_RELEASE_CONFIGURATION)
         set(arg_RELEASE_CONFIGURATION Release)
     endif()
@@ -0,0 +1,88 @@
+# vcpkg_replace_strings(
+#     FILES <file>...
+#     [REPLACE <match> <replace>]...
+#     [REGEX_REPLACE <regex> <replace>]...
+#     [IGNORE_UNCHANGED]
+# )
+#
+# Applies all replacements, in the given order, to each file. Every file is read
+# once and only written back if at least one replacement matched. Unless
+# IGNORE_UNCHANGED is given, a replacement which matches nothing in a file is reported.
+function(vcpkg_replace_strings)
+    set(files "")
+    set(kinds "")
+    set(matches "")
+    set(replacements "")
+    set(ignore_unchanged OFF)
+    set(mode "")
+    set(index 0)
+    while(index LESS ARGC)
+        set(arg "${ARGV${index}}")
+        if(arg STREQUAL "FILES")
+            set(mode "FILES")
+        elseif(arg STREQUAL "REPLACE" OR arg STREQUAL "REGEX_REPLACE")
+            math(EXPR replace_index "${index} + 2")
+            if(NOT replace_index LESS ARGC)
+                message(FATAL_ERROR "${CMAKE_CURRENT_FUNCTION}: ${arg} requires a match and a replacement.")
+            endif()
+            math(EXPR match_index "${index} + 1")
+            # Indices instead of values keep semicolons and empty strings intact.
+            list(APPEND kinds "${arg}")
+            list(APPEND matches "${match_index}")
+            list(APPEND replacements "${replace_index}")
+            set(index "${replace_index}")
+            set(mode "")
+        elseif(arg STREQUAL "IGNORE_UNCHANGED")
+            set(ignore_unchanged ON)
+            set(mode "")
+        elseif(mode STREQUAL "FILES")
+            list(APPEND files "${arg}")
+        else()
+            message(FATAL_ERROR "${CMAKE_CURRENT_FUNCTION} was passed extra arguments: ${arg}")
+        endif()
+        math(EXPR index "${index} + 1")
+    endwhile()
+
+    if(files STREQUAL "")
+        message(FATAL_ERROR "${CMAKE_CURRENT_FUNCTION} requires at least one file passed to FILES.")
+    endif()
+    list(LENGTH kinds count)
+    if(count EQUAL "0")
+        return()
+    endif()
+    math(EXPR last "${count} - 1")
+
+    foreach(file IN LISTS files)
+        file(READ "${file}" contents)
+        set(changed OFF)
+        foreach(pair RANGE "${last}")
+            list(GET kinds "${pair}" kind)
+            list(GET matches "${pair}" match_index)
+            list(GET replacements "${pair}" replace_index)
+            set(match "${ARGV${match_index}}")
+            set(replace "${ARGV${replace_index}}")
+            if(kind STREQUAL "REGEX_REPLACE")
+                if(contents MATCHES "${match}")
+                    string(REGEX REPLACE "${match}" "${replace}" contents "${contents}")
+                    set(changed ON)
+                    continue()
+                endif()
+            elseif("${match}" STREQUAL "${replace}")
+                continue() # Avoid triggering warnings
+            else()
+                string(FIND "${contents}" "${match}" match_position)
+                if(NOT match_position EQUAL "-1")
+                    string(REPLACE "${match}" "${replace}" contents "${contents}")
+                    set(changed ON)
+                    continue()
+                endif()
+            endif()
+            if(NOT ignore_unchanged)
+                message("${Z_VCPKG_BACKCOMPAT_MESSAGE_LEVEL}" "vcpkg_replace_string made no changes: '${match}' not found in ${file}")
+            endif()
+        endforeach()
+        if(changed)
+            file(WRITE "${file}" "${contents}")
+        endif()
+    endforeach()
+endfunction()
@@ -0,0 +1,71 @@
+# Adaptive job count for build helpers, enabled by setting VCPKG_ADAPTIVE_CONCURRENCY in the
+# triplet or in the environment.
+#
+# Build helpers call z_vcpkg_adaptive_concurrency(<helper>) before starting a build. It lowers
+# VCPKG_CONCURRENCY in the scope of the helper to the number of idle logical cores (according to
+# the load average) and to the number of jobs which fit into the available memory, given
+# VCPKG_ADAPTIVE_CONCURRENCY_JOB_MEMORY MiB per job (default: 1024). It never raises the job count
+# above the one passed by vcpkg. The decisions are logged to
+# ${CURRENT_BUILDTREES_DIR}/concurrency-${TARGET_TRIPLET}.log.
+# Z_VCPKG_ADAPTIVE_CONCURRENCY is set to ON in the scope of the helper when the job count was
+# computed, so that helpers of build tools with an implicit default (ninja) can pass it explicitly.
+
+function(z_vcpkg_adaptive_concurrency_load_average out_var)
+    set(load "")
+    if(EXISTS "/proc/loadavg")
+        file(READ "/proc/loadavg" load)
+    elseif(CMAKE_HOST_APPLE)
+        execute_process(COMMAND sysctl -n vm.loadavg OUTPUT_VARIABLE load ERROR_QUIET)
+    endif()
+    # The one minute average, without fraction
+    if(load MATCHES "^[{ ]*([0-9]+)")
+        set("${out_var}" "${CMAKE_MATCH_1}" PARENT_SCOPE)
+    else()
+        set("${out_var}" "" PARENT_SCOPE)
+    endif()
+endfunction()
+
+function(z_vcpkg_adaptive_concurrency helper)
+    set(Z_VCPKG_ADAPTIVE_CONCURRENCY OFF PARENT_SCOPE)
+    if(NOT VCPKG_ADAPTIVE_CONCURRENCY AND NOT "$ENV{VCPKG_ADAPTIVE_CONCURRENCY}")
+        return()
+    endif()
+
+    # Nested helpers (vcpkg_cmake_install -> vcpkg_cmake_build) start from the same limit.
+    get_property(max_jobs GLOBAL PROPERTY Z_VCPKG_ADAPTIVE_CONCURRENCY_MAX)
+    if("${max_jobs}" STREQUAL "")
+        set(max_jobs "${VCPKG_CONCURRENCY}")
+        set_property(GLOBAL PROPERTY Z_VCPKG_ADAPTIVE_CONCURRENCY_MAX "${max_jobs}")
+    endif()
+    set(job_memory 1024)
+    if(DEFINED VCPKG_ADAPTIVE_CONCURRENCY_JOB_MEMORY)
+        set(job_memory "${VCPKG_ADAPTIVE_CONCURRENCY_JOB_MEMORY}")
+    endif()
+
+    set(jobs "${max_jobs}")
+    cmake_host_system_information(RESULT host_info QUERY NUMBER_OF_LOGICAL_CORES AVAILABLE_PHYSICAL_MEMORY)
+    list(GET host_info 0 cores)
+    list(GET host_info 1 available_memory)
+    z_vcpkg_adaptive_concurrency_load_average(load)
+    if(NOT load STREQUAL "")
+        math(EXPR idle_cores "${cores} - ${load}")
+        if(idle_cores LESS jobs)
+            set(jobs "${idle_cores}")
+        endif()
+    else()
+        set(load "unknown")
+    endif()
+    math(EXPR memory_jobs "${available_memory} / ${job_memory}")
+    if(memory_jobs LESS jobs)
+        set(jobs "${memory_jobs}")
+    endif()
+    if(jobs LESS "1")
+        set(jobs 1)
+    endif()
+
+    set(decision "${helper}: ${jobs} of ${max_jobs} jobs (load ${load} on ${cores} cores, available memory ${available_memory} MiB)")
+    message(STATUS "Adaptive concurrency for ${decision}")
+    file(APPEND "${CURRENT_BUILDTREES_DIR}/concurrency-${TARGET_TRIPLET}.log" "${decision}\n")
+    set(VCPKG_CONCURRENCY "${jobs}" PARENT_SCOPE)
+    set(Z_VCPKG_ADAPTIVE_CONCURRENCY ON PARENT_SCOPE)
+endfunction()
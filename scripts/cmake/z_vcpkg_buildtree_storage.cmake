@@ -0,0 +1,129 @@
+# Opt-in storage policies for build directories.
+#
+# VCPKG_RECLAIM_BUILDTREES: after the install step of a configuration succeeded, remove its
+# object files and precompiled headers, and gzip its logs which are larger than 64 KiB in place.
+#
+# VCPKG_BUILDTREES_TMPFS=<directory>: create the configuration build directories on a RAM-backed
+# file system such as /dev/shm. The build directories in the buildtree become symbolic links.
+# They are only created there if at least VCPKG_BUILDTREES_TMPFS_SIZE MiB (default: 4096) are
+# available; otherwise they are created on disk. Directories of earlier builds are removed as
+# soon as no build directory links to them anymore.
+
+function(z_vcpkg_buildtree_tmpfs_prune tmpfs_dir)
+    file(GLOB owner_files "${tmpfs_dir}/vcpkg-buildtree-*.owner")
+    foreach(owner_file IN LISTS owner_files)
+        string(REGEX REPLACE "\\.owner\$" "" group_dir "${owner_file}")
+        file(STRINGS "${owner_file}" links)
+        set(in_use OFF)
+        foreach(link IN LISTS links)
+            if(IS_SYMLINK "${link}")
+                file(READ_SYMLINK "${link}" link_target)
+                cmake_path(GET link_target PARENT_PATH link_parent)
+                if(link_parent STREQUAL group_dir)
+                    set(in_use ON)
+                endif()
+            endif()
+        endforeach()
+        if(NOT in_use)
+            file(REMOVE_RECURSE "${group_dir}")
+            file(REMOVE "${owner_file}")
+        endif()
+    endforeach()
+endfunction()
+
+function(z_vcpkg_buildtree_tmpfs_available out_var tmpfs_dir)
+    set("${out_var}" "" PARENT_SCOPE)
+    execute_process(
+        COMMAND df -Pk "${tmpfs_dir}"
+        OUTPUT_VARIABLE output
+        ERROR_QUIET
+        RESULT_VARIABLE result
+    )
+    if(result STREQUAL "0" AND output MATCHES "\n[^ ]+ +[0-9]+ +[0-9]+ +([0-9]+)")
+        math(EXPR available "${CMAKE_MATCH_1} / 1024")
+        set("${out_var}" "${available}" PARENT_SCOPE)
+    endif()
+endfunction()
+
+# Creates the given build directories. They are placed side by side, so that relative paths
+# between them stay valid when they are created on tmpfs.
+function(z_vcpkg_buildtree_make_directories)
+    set(tmpfs_dir "${VCPKG_BUILDTREES_TMPFS}")
+    if(tmpfs_dir STREQUAL "" OR CMAKE_HOST_WIN32)
+        file(MAKE_DIRECTORY ${ARGN})
+        return()
+    endif()
+
+    z_vcpkg_buildtree_tmpfs_prune("${tmpfs_dir}")
+    set(required 4096)
+    if(DEFINED VCPKG_BUILDTREES_TMPFS_SIZE)
+        set(required "${VCPKG_BUILDTREES_TMPFS_SIZE}")
+    endif()
+    z_vcpkg_buildtree_tmpfs_available(available "${tmpfs_dir}")
+    if(available STREQUAL "" OR available LESS required)
+        message(STATUS "Not using ${tmpfs_dir} for build directories: ${available} MiB available, ${required} MiB required")
+        file(MAKE_DIRECTORY ${ARGN})
+        return()
+    endif()
+
+    string(RANDOM LENGTH 8 suffix)
+    set(group_dir "${tmpfs_dir}/vcpkg-buildtree-${PORT}-${TARGET_TRIPLET}-${suffix}")
+    set(links "")
+    set(created_links "")
+    foreach(dir IN LISTS ARGN)
+        cmake_path(GET dir FILENAME name)
+        file(MAKE_DIRECTORY "${group_dir}/${name}")
+        file(REMOVE_RECURSE "${dir}")
+        file(CREATE_LINK "${group_dir}/${name}" "${dir}" SYMBOLIC RESULT link_result)
+        if(NOT link_result STREQUAL "0")
+            message(STATUS "Not using ${tmpfs_dir} for build directories: ${link_result}")
+            file(REMOVE ${created_links})
+            file(REMOVE_RECURSE "${group_dir}")
+            file(MAKE_DIRECTORY ${ARGN})
+            return()
+        endif()
+        list(APPEND created_links "${dir}")
+        string(APPEND links "${dir}\n")
+    endforeach()
+    # Written last: groups without owner file are never pruned.
+    file(WRITE "${group_dir}.owner" "${links}")
+    message(STATUS "Using ${group_dir} for build directories (${available} MiB available)")
+endfunction()
+
+# Reclaims disk space of a configuration after its install step succeeded.
+# `log_infix` selects the logs of the configuration, e.g. `${TARGET_TRIPLET}-rel`.
+function(z_vcpkg_buildtree_reclaim build_dir log_infix)
+    # Editable builds keep their objects for incremental rebuilds.
+    if(NOT VCPKG_RECLAIM_BUILDTREES OR _VCPKG_EDITABLE)
+        return()
+    endif()
+    set(reclaimed 0)
+    file(GLOB_RECURSE objects LIST_DIRECTORIES false
+        "${build_dir}/*.o"
+        "${build_dir}/*.obj"
+        "${build_dir}/*.pch"
+        "${build_dir}/*.gch"
+    )
+    foreach(object IN LISTS objects)
+        file(SIZE "${object}" size)
+        math(EXPR reclaimed "${reclaimed} + ${size}")
+    endforeach()
+    if(NOT objects STREQUAL "")
+        file(REMOVE ${objects})
+    endif()
+
+    file(GLOB logs "${CURRENT_BUILDTREES_DIR}/*-${log_infix}-*.log" "${CURRENT_BUILDTREES_DIR}/*-${log_infix}.log")
+    foreach(log IN LISTS logs)
+        file(SIZE "${log}" size)
+        if(size LESS "65536")
+            continue()
+        endif()
+        file(ARCHIVE_CREATE OUTPUT "${log}.gz" PATHS "${log}" FORMAT raw COMPRESSION GZip)
+        file(SIZE "${log}.gz" compressed_size)
+        math(EXPR reclaimed "${reclaimed} + ${size} - ${compressed_size}")
+        file(REMOVE "${log}")
+    endforeach()
+
+    math(EXPR reclaimed "${reclaimed} / 1048576")
+    message(STATUS "Reclaimed ${reclaimed} MiB in ${log_infix} build directory and logs")
+endfunction()
@@ -15,22 +15,34 @@ function(z_vcpkg_get_cmake_vars out_file)
     if(NOT DEFINED CACHE{${cache_var}})
         set(${cache_var}  "${cmake_vars_file}"
             CACHE PATH "The file to include to access the CMake variables from a generated project.")
-        vcpkg_configure_cmake(
-            SOURCE_PATH "${SCRIPTS}/get_cmake_vars"
-            OPTIONS_DEBUG "-DVCPKG_OUTPUT_FILE:PATH=${CURRENT_BUILDTREES_DIR}/cmake-vars-${TARGET_TRIPLET}-dbg.cmake.log"
-            OPTIONS_RELEASE "-DVCPKG_OUTPUT_FILE:PATH=${CURRENT_BUILDTREES_DIR}/cmake-vars-${TARGET_TRIPLET}-rel.cmake.log"
-            PREFER_NINJA
-            LOGNAME get-cmake-vars-${TARGET_TRIPLET}
-            Z_GET_CMAKE_VARS_USAGE # ignore vcpkg_cmake_configure, be quiet, don't set variables...
-        )
-
+        set(output_files "")
         set(include_string "")
         if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "release")
+            list(APPEND output_files "${CURRENT_BUILDTREES_DIR}/cmake-vars-${TARGET_TRIPLET}-rel.cmake.log")
             string(APPEND include_string "include(\"\${CMAKE_CURRENT_LIST_DIR}/cmake-vars-${TARGET_TRIPLET}-rel.cmake.log\")\n")
         endif()
         if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "debug")
+            list(APPEND output_files "${CURRENT_BUILDTREES_DIR}/cmake-vars-${TARGET_TRIPLET}-dbg.cmake.log")
             string(APPEND include_string "include(\"\${CMAKE_CURRENT_LIST_DIR}/cmake-vars-${TARGET_TRIPLET}-dbg.cmake.log\")\n")
         endif()
+
+        z_vcpkg_get_cmake_vars_cache_restore(
+            SOURCE_PATH "${SCRIPTS}/get_cmake_vars"
+            OUTPUT_FILES ${output_files}
+            OUT_KEY cache_key
+            OUT_RESTORED restored
+        )
+        if(NOT restored)
+            vcpkg_configure_cmake(
+                SOURCE_PATH "${SCRIPTS}/get_cmake_vars"
+                OPTIONS_DEBUG "-DVCPKG_OUTPUT_FILE:PATH=${CURRENT_BUILDTREES_DIR}/cmake-vars-${TARGET_TRIPLET}-dbg.cmake.log"
+                OPTIONS_RELEASE "-DVCPKG_OUTPUT_FILE:PATH=${CURRENT_BUILDTREES_DIR}/cmake-vars-${TARGET_TRIPLET}-rel.cmake.log"
+                PREFER_NINJA
+                LOGNAME get-cmake-vars-${TARGET_TRIPLET}
+                Z_GET_CMAKE_VARS_USAGE # ignore vcpkg_cmake_configure, be quiet, don't set variables...
+            )
+            z_vcpkg_get_cmake_vars_cache_store(KEY "${cache_key}" OUTPUT_FILES ${output_files})
+        endif()
         file(WRITE "${cmake_vars_file}" "${include_string}")
     endif()
 
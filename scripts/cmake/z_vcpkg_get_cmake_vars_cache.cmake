@@ -0,0 +1,142 @@
+include_guard(GLOBAL)
+
+# Shares the output files of the CMake variable detection projects (z_vcpkg_get_cmake_vars,
+# vcpkg_cmake_get_vars) between ports. Entries are keyed by triplet, toolchain and flags.
+
+set(Z_VCPKG_GET_CMAKE_VARS_CACHE_ENV_VARS
+    PATH INCLUDE C_INCLUDE_PATH CPLUS_INCLUDE_PATH LIB LIBPATH LIBRARY_PATH LD_LIBRARY_PATH
+    CC CXX CPP AR AS LD NM RANLIB STRIP CFLAGS CXXFLAGS CPPFLAGS LDFLAGS
+    SDKROOT MACOSX_DEPLOYMENT_TARGET ANDROID_NDK_HOME VCINSTALLDIR VCToolsInstallDir WindowsSdkDir
+)
+
+function(z_vcpkg_get_cmake_vars_cache_dir out_var)
+    if(VCPKG_GET_CMAKE_VARS_NO_CACHE)
+        set("${out_var}" "" PARENT_SCOPE)
+    else()
+        get_filename_component(buildtrees_dir "${CURRENT_BUILDTREES_DIR}" DIRECTORY)
+        set("${out_var}" "${buildtrees_dir}/vcpkg-get-cmake-vars-cache" PARENT_SCOPE)
+    endif()
+endfunction()
+
+# Describes the detected compilers by resolved path, size and timestamp.
+function(z_vcpkg_get_cmake_vars_cache_compiler_stamp out_var)
+    set(stamp "")
+    foreach(output_file IN LISTS ARGN)
+        include("${output_file}")
+        get_cmake_property(variables VARIABLES)
+        list(FILTER variables INCLUDE REGEX "^VCPKG_DETECTED_CMAKE_[A-Z]+_COMPILER\$")
+        list(SORT variables)
+        foreach(variable IN LISTS variables)
+            set(compiler "${${variable}}")
+            if(IS_ABSOLUTE "${compiler}" AND EXISTS "${compiler}")
+                file(REAL_PATH "${compiler}" real_path)
+                file(SIZE "${real_path}" size)
+                file(TIMESTAMP "${real_path}" timestamp "%Y-%m-%dT%H:%M:%S.%f" UTC)
+                string(APPEND stamp "${variable}|${real_path}|${size}|${timestamp}\n")
+            endif()
+        endforeach()
+    endforeach()
+    set("${out_var}" "${stamp}" PARENT_SCOPE)
+endfunction()
+
+# Computes the fingerprint of a detection run and tries to restore its output files.
+# OUT_RESTORED is set to ON if all of OUTPUT_FILES were restored from the cache.
+function(z_vcpkg_get_cmake_vars_cache_restore)
+    cmake_parse_arguments(PARSE_ARGV 0 arg "" "SOURCE_PATH;OUT_KEY;OUT_RESTORED" "OPTIONS;OUTPUT_FILES")
+    if(DEFINED arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "${CMAKE_CURRENT_FUNCTION} was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+    set("${arg_OUT_KEY}" "" PARENT_SCOPE)
+    set("${arg_OUT_RESTORED}" OFF PARENT_SCOPE)
+
+    z_vcpkg_get_cmake_vars_cache_dir(cache_dir)
+    if(cache_dir STREQUAL "")
+        return()
+    endif()
+
+    set(key_data "cmake=${CMAKE_VERSION}\ntriplet=${TARGET_TRIPLET}\ninstalled=${CURRENT_INSTALLED_DIR}\n")
+    string(APPEND key_data "options=${arg_OPTIONS}\n")
+    file(GLOB_RECURSE input_files "${arg_SOURCE_PATH}/*")
+    list(APPEND input_files
+        "${CMAKE_TRIPLET_FILE}"
+        "${VCPKG_CHAINLOAD_TOOLCHAIN_FILE}"
+        "${SCRIPTS}/buildsystems/vcpkg.cmake"
+    )
+    file(GLOB toolchain_files "${SCRIPTS}/toolchains/*.cmake")
+    list(APPEND input_files ${toolchain_files})
+    foreach(input_file IN LISTS input_files)
+        if(NOT input_file STREQUAL "" AND EXISTS "${input_file}" AND NOT IS_DIRECTORY "${input_file}")
+            file(SHA512 "${input_file}" input_hash)
+            string(APPEND key_data "file=${input_file}|${input_hash}\n")
+        endif()
+    endforeach()
+    # Triplet and portfile settings (flags, system name, linkage, configure options, ...)
+    get_cmake_property(variables VARIABLES)
+    list(FILTER variables INCLUDE REGEX "^VCPKG_")
+    list(FILTER variables EXCLUDE REGEX "^VCPKG_(POLICY|DETECTED|COMBINED)_")
+    list(SORT variables)
+    foreach(variable IN LISTS variables)
+        string(APPEND key_data "var=${variable}|${${variable}}\n")
+    endforeach()
+    foreach(variable IN LISTS Z_VCPKG_GET_CMAKE_VARS_CACHE_ENV_VARS)
+        string(APPEND key_data "env=${variable}|$ENV{${variable}}\n")
+    endforeach()
+    string(SHA512 key "${key_data}")
+    string(SUBSTRING "${key}" 0 16 key)
+    set(key "${TARGET_TRIPLET}-${key}")
+    set("${arg_OUT_KEY}" "${key}" PARENT_SCOPE)
+
+    set(entry "${cache_dir}/${key}")
+    if(NOT EXISTS "${entry}/compilers.txt")
+        return()
+    endif()
+    set(cached_files "")
+    foreach(output_file IN LISTS arg_OUTPUT_FILES)
+        get_filename_component(name "${output_file}" NAME)
+        if(NOT EXISTS "${entry}/${name}")
+            return()
+        endif()
+        list(APPEND cached_files "${entry}/${name}")
+    endforeach()
+    file(READ "${entry}/compilers.txt" cached_stamp)
+    z_vcpkg_get_cmake_vars_cache_compiler_stamp(current_stamp ${cached_files})
+    if(NOT current_stamp STREQUAL cached_stamp)
+        message(STATUS "Detected compilers changed, discarding cached CMake variables ${key}")
+        file(REMOVE_RECURSE "${entry}")
+        return()
+    endif()
+
+    foreach(output_file IN LISTS arg_OUTPUT_FILES)
+        get_filename_component(name "${output_file}" NAME)
+        configure_file("${entry}/${name}" "${output_file}" COPYONLY)
+    endforeach()
+    message(STATUS "Using cached CMake variables ${key}")
+    set("${arg_OUT_RESTORED}" ON PARENT_SCOPE)
+endfunction()
+
+# Publishes the output files of a finished detection run under KEY.
+function(z_vcpkg_get_cmake_vars_cache_store)
+    cmake_parse_arguments(PARSE_ARGV 0 arg "" "KEY" "OUTPUT_FILES")
+    if(DEFINED arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "${CMAKE_CURRENT_FUNCTION} was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+    z_vcpkg_get_cmake_vars_cache_dir(cache_dir)
+    if(cache_dir STREQUAL "" OR "${arg_KEY}" STREQUAL "")
+        return()
+    endif()
+
+    set(entry "${cache_dir}/${arg_KEY}")
+    string(RANDOM LENGTH 8 suffix)
+    set(temp_entry "${entry}.${suffix}.tmp")
+    file(MAKE_DIRECTORY "${temp_entry}")
+    foreach(output_file IN LISTS arg_OUTPUT_FILES)
+        file(COPY "${output_file}" DESTINATION "${temp_entry}")
+    endforeach()
+    z_vcpkg_get_cmake_vars_cache_compiler_stamp(stamp ${arg_OUTPUT_FILES})
+    file(WRITE "${temp_entry}/compilers.txt" "${stamp}")
+    # Another port may have published the same entry concurrently; its content is equivalent.
+    file(RENAME "${temp_entry}" "${entry}" RESULT rename_result)
+    if(NOT rename_result STREQUAL "0")
+        file(REMOVE_RECURSE "${temp_entry}")
+    endif()
+endfunction()
@@ -0,0 +1,168 @@
+include_guard(GLOBAL)
+
+# Records which helper functions and helper files a port executed. Functions are recorded when they
+# are called and list files when they are included; macros are found by scanning the executed files.
+# Enabled by VCPKG_RECORD_HELPER_USAGE in the triplet or environment; the manifest is written to
+# ${CURRENT_BUILDTREES_DIR}/helper-usage-${TARGET_TRIPLET}.json and summarized by scripts/helperUsageReport.py.
+
+function(z_vcpkg_helper_usage_watch variable access value)
+    if(access STREQUAL "MODIFIED_ACCESS")
+        get_property(seen GLOBAL PROPERTY "z_vcpkg_helper_usage_${value}" SET)
+        if(NOT seen)
+            set_property(GLOBAL PROPERTY "z_vcpkg_helper_usage_${value}" ON)
+            set_property(GLOBAL APPEND PROPERTY Z_VCPKG_HELPER_USAGE_FUNCTIONS "${value}")
+        endif()
+    endif()
+endfunction()
+
+# CMAKE_CURRENT_LIST_FILE cannot be watched, but CMAKE_CURRENT_LIST_DIR is set right after it
+# whenever a list file is entered or left.
+function(z_vcpkg_helper_usage_watch_list variable access value)
+    if(access STREQUAL "MODIFIED_ACCESS" AND NOT CMAKE_CURRENT_LIST_FILE STREQUAL "")
+        get_property(seen GLOBAL PROPERTY "z_vcpkg_helper_usage_list_${CMAKE_CURRENT_LIST_FILE}" SET)
+        if(NOT seen)
+            set_property(GLOBAL PROPERTY "z_vcpkg_helper_usage_list_${CMAKE_CURRENT_LIST_FILE}" ON)
+            set_property(GLOBAL APPEND PROPERTY Z_VCPKG_HELPER_USAGE_LIST_FILES "${CMAKE_CURRENT_LIST_FILE}")
+        endif()
+    endif()
+endfunction()
+
+function(z_vcpkg_helper_usage_start)
+    if(VCPKG_RECORD_HELPER_USAGE OR "$ENV{VCPKG_RECORD_HELPER_USAGE}")
+        set_property(GLOBAL PROPERTY Z_VCPKG_HELPER_USAGE_ENABLED ON)
+        # Every function call sets CMAKE_CURRENT_FUNCTION; macros are only found through their callers.
+        variable_watch(CMAKE_CURRENT_FUNCTION z_vcpkg_helper_usage_watch)
+        variable_watch(CMAKE_CURRENT_LIST_DIR z_vcpkg_helper_usage_watch_list)
+    endif()
+endfunction()
+
+# Maps an executed helper file to the path of its source in the vcpkg root where possible.
+function(z_vcpkg_helper_usage_source_path out_var file)
+    file(RELATIVE_PATH relative "${VCPKG_ROOT_DIR}" "${file}")
+    if(NOT relative MATCHES "^\\.\\./")
+        set("${out_var}" "${relative}" PARENT_SCOPE)
+        return()
+    endif()
+    foreach(installed_dir IN ITEMS "${CURRENT_HOST_INSTALLED_DIR}" "${CURRENT_INSTALLED_DIR}")
+        file(RELATIVE_PATH relative "${installed_dir}/share" "${file}")
+        if(NOT relative MATCHES "^\\.\\./" AND EXISTS "${VCPKG_ROOT_DIR}/ports/${relative}")
+            set("${out_var}" "ports/${relative}" PARENT_SCOPE)
+            return()
+        endif()
+    endforeach()
+    set("${out_var}" "${file}" PARENT_SCOPE)
+endfunction()
+
+function(z_vcpkg_helper_usage_write)
+    get_property(enabled GLOBAL PROPERTY Z_VCPKG_HELPER_USAGE_ENABLED)
+    if(NOT enabled)
+        return()
+    endif()
+    get_property(functions GLOBAL PROPERTY Z_VCPKG_HELPER_USAGE_FUNCTIONS)
+    list(FILTER functions EXCLUDE REGEX "^z_vcpkg_helper_usage_")
+
+    # Helper files are the scripts and the cmake files of installed helper ports.
+    file(GLOB candidates "${SCRIPTS}/ports.cmake" "${SCRIPTS}/cmake/*.cmake")
+    foreach(installed_dir IN ITEMS "${CURRENT_HOST_INSTALLED_DIR}" "${CURRENT_INSTALLED_DIR}")
+        file(GLOB port_configs "${installed_dir}/share/*/vcpkg-port-config.cmake")
+        foreach(port_config IN LISTS port_configs)
+            get_filename_component(port_share "${port_config}" DIRECTORY)
+            file(GLOB port_files "${port_share}/*.cmake")
+            list(APPEND candidates ${port_files})
+        endforeach()
+    endforeach()
+    list(REMOVE_DUPLICATES candidates)
+    set(macros "")
+    foreach(candidate IN LISTS candidates)
+        file(STRINGS "${candidate}" definitions REGEX "^[ \t]*(function|macro)[ \t]*\\(")
+        foreach(definition IN LISTS definitions)
+            if(definition MATCHES "^[ \t]*(function|macro)[ \t]*\\([ \t]*([A-Za-z0-9_]+)")
+                set("z_definition_${CMAKE_MATCH_2}" "${candidate}")
+                if(CMAKE_MATCH_1 STREQUAL "macro")
+                    list(APPEND macros "${CMAKE_MATCH_2}")
+                endif()
+            endif()
+        endforeach()
+    endforeach()
+    list(REMOVE_DUPLICATES macros)
+
+    # These run for every port.
+    set(used_files
+        "${SCRIPTS}/ports.cmake"
+        "${SCRIPTS}/cmake/vcpkg_common_definitions.cmake"
+        "${SCRIPTS}/build_info.cmake"
+    )
+    set(function_entries "")
+    list(SORT functions)
+    foreach(function_name IN LISTS functions)
+        if(DEFINED "z_definition_${function_name}")
+            set(defining_file "${z_definition_${function_name}}")
+            list(APPEND used_files "${defining_file}")
+            z_vcpkg_helper_usage_source_path(source_path "${defining_file}")
+            list(APPEND function_entries "    \"${function_name}\": \"${source_path}\"")
+        endif()
+    endforeach()
+
+    # Included helper files, e.g. vcpkg_find_acquire_program(NINJA).cmake
+    get_property(list_files GLOBAL PROPERTY Z_VCPKG_HELPER_USAGE_LIST_FILES)
+    foreach(list_file IN LISTS list_files)
+        if(list_file IN_LIST candidates)
+            list(APPEND used_files "${list_file}")
+        endif()
+    endforeach()
+
+    # Macros called by the port or by the executed helper files. A call in a branch which was not
+    # taken is recorded, too.
+    file(GLOB scanned_files "${CURRENT_PORT_DIR}/*.cmake")
+    list(APPEND scanned_files ${used_files})
+    list(REMOVE_DUPLICATES scanned_files)
+    while(NOT scanned_files STREQUAL "")
+        set(new_files "")
+        foreach(scanned_file IN LISTS scanned_files)
+            if(NOT EXISTS "${scanned_file}")
+                continue()
+            endif()
+            file(READ "${scanned_file}" contents)
+            foreach(macro_name IN LISTS macros)
+                if(contents MATCHES "(^|[^A-Za-z0-9_])${macro_name}[ \t]*\\(")
+                    set(defining_file "${z_definition_${macro_name}}")
+                    if(NOT defining_file IN_LIST used_files)
+                        list(APPEND used_files "${defining_file}")
+                        list(APPEND new_files "${defining_file}")
+                    endif()
+                    if(NOT macro_name IN_LIST functions)
+                        z_vcpkg_helper_usage_source_path(source_path "${defining_file}")
+                        list(APPEND function_entries "    \"${macro_name}\": \"${source_path}\"")
+                        list(APPEND functions "${macro_name}")
+                    endif()
+                endif()
+            endforeach()
+        endforeach()
+        set(scanned_files "${new_files}")
+    endwhile()
+    list(REMOVE_DUPLICATES used_files)
+    list(SORT function_entries)
+
+    set(file_entries "")
+    foreach(used_file IN LISTS used_files)
+        if(EXISTS "${used_file}")
+            file(SHA512 "${used_file}" hash)
+            z_vcpkg_helper_usage_source_path(source_path "${used_file}")
+            list(APPEND file_entries "    \"${source_path}\": \"${hash}\"")
+        endif()
+    endforeach()
+    list(SORT file_entries)
+    list(JOIN function_entries ",\n" function_entries)
+    list(JOIN file_entries ",\n" file_entries)
+    file(WRITE "${CURRENT_BUILDTREES_DIR}/helper-usage-${TARGET_TRIPLET}.json" "{
+  \"port\": \"${PORT}\",
+  \"triplet\": \"${TARGET_TRIPLET}\",
+  \"functions\": {
+${function_entries}
+  },
+  \"files\": {
+${file_entries}
+  }
+}
+")
+endfunction()
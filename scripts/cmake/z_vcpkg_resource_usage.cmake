@@ -0,0 +1,26 @@
+# Resource accounting for build steps, enabled by setting VCPKG_RECORD_RESOURCE_USAGE in the triplet.
+# Each wrapped command appends one JSON line with its exit code, wall time, user and system
+# CPU time, peak RSS and block I/O to ${CURRENT_BUILDTREES_DIR}/resource-usage-${TARGET_TRIPLET}.jsonl.
+# See scripts/resourceUsageReport.py for a roll-up over all ports.
+
+# Prepends the accounting wrapper to the command list in `command_var`.
+function(z_vcpkg_resource_usage_wrap command_var logname)
+    if(NOT VCPKG_RECORD_RESOURCE_USAGE OR Z_VCPKG_RESOURCE_USAGE_IN_WRAP)
+        return()
+    endif()
+    if(CMAKE_HOST_WIN32)
+        if(NOT Z_VCPKG_RESOURCE_USAGE_WARNED)
+            message(WARNING "VCPKG_RECORD_RESOURCE_USAGE is not supported on Windows hosts.")
+            set(Z_VCPKG_RESOURCE_USAGE_WARNED ON CACHE INTERNAL "")
+        endif()
+        return()
+    endif()
+    # Finding python may run processes itself.
+    set(Z_VCPKG_RESOURCE_USAGE_IN_WRAP ON)
+    vcpkg_find_acquire_program(PYTHON3)
+    vcpkg_list(PREPEND "${command_var}"
+        "${PYTHON3}" "${SCRIPTS}/cmake/z_vcpkg_resource_usage.py"
+        "${CURRENT_BUILDTREES_DIR}/resource-usage-${TARGET_TRIPLET}.jsonl" "${logname}" "--"
+    )
+    set("${command_var}" "${${command_var}}" PARENT_SCOPE)
+endfunction()
@@ -0,0 +1,56 @@
+# Runs a command and appends its resource usage to a JSON lines file.
+# Usage: z_vcpkg_resource_usage.py <summary-file> <step> -- <command>...
+#
+# The values come from wait4(), so they cover the command and all descendants it waited for.
+# max_rss_kib is the peak of the largest single process, not the sum over the process tree.
+# read_bytes and written_bytes count block device I/O; reads served from the page cache are not included.
+import json
+import os
+import signal
+import sys
+import time
+
+
+def main():
+    summary_path, step = sys.argv[1], sys.argv[2]
+    command = sys.argv[4:]
+
+    start = time.monotonic()
+    pid = os.fork()
+    if pid == 0:
+        try:
+            os.execvp(command[0], command)
+        except OSError as error:
+            print(f'{command[0]}: {error}', file=sys.stderr)
+            os._exit(127)
+    _, status, usage = os.wait4(pid, 0)
+    wall_seconds = time.monotonic() - start
+
+    max_rss_kib = usage.ru_maxrss
+    if sys.platform == 'darwin':
+        max_rss_kib //= 1024  # bytes on macOS
+    record = {
+        'step': step,
+        'command': command,
+        'exit_code': os.waitstatus_to_exitcode(status),
+        'wall_seconds': round(wall_seconds, 3),
+        'user_seconds': round(usage.ru_utime, 3),
+        'system_seconds': round(usage.ru_stime, 3),
+        'max_rss_kib': max_rss_kib,
+        'read_bytes': usage.ru_inblock * 512,
+        'written_bytes': usage.ru_oublock * 512,
+    }
+    with open(summary_path, 'a') as summary:
+        summary.write(json.dumps(record) + '\n')
+
+    if os.WIFSIGNALED(status):
+        # Report the signal to the caller as if the command had run directly.
+        term_signal = os.WTERMSIG(status)
+        if term_signal not in (signal.SIGKILL, signal.SIGSTOP):
+            signal.signal(term_signal, signal.SIG_DFL)
+        os.kill(os.getpid(), term_signal)
+    sys.exit(os.WEXITSTATUS(status))
+
+
+if __name__ == "__main__":
+    main()
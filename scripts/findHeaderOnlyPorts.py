@@ -0,0 +1,89 @@
+import os
+import re
+import argparse
+
+from pathlib import Path
+
+
+SCRIPT_DIRECTORY = os.path.dirname(os.path.abspath(__file__))
+PORTS_DIRECTORY = os.path.join(SCRIPT_DIRECTORY, '../ports')
+INSTALLED_DIRECTORY = os.path.join(SCRIPT_DIRECTORY, '../installed')
+
+# Helpers which start a compiler even when the port only installs headers.
+BUILD_SYSTEM_REGEX = re.compile(
+    r'\b(vcpkg_cmake_configure|vcpkg_configure_cmake|vcpkg_configure_meson|boost_configure_and_install)\s*\(')
+HEADER_ONLY_REGEX = re.compile(r'header[- ]only', re.IGNORECASE)
+RELEASE_ONLY_REGEX = re.compile(r'set\s*\(\s*VCPKG_BUILD_TYPE\s+release\s*\)')
+# Ports doing any of these produce more than headers and config files.
+DISQUALIFYING_REGEX = re.compile(
+    r'\b(vcpkg_copy_tools|vcpkg_copy_pdbs|vcpkg_cmake_build|vcpkg_check_linkage)\s*\(')
+
+
+def read_portfile(port_name):
+    portfile_path = os.path.join(PORTS_DIRECTORY, port_name, 'portfile.cmake')
+    if not os.path.exists(portfile_path):
+        return None
+    with open(portfile_path, 'r', encoding='utf-8', errors='replace') as portfile:
+        return portfile.read()
+
+
+def find_candidates_in_portfiles():
+    # Static scan: a release-only or self-described header-only port which still configures a build system.
+    candidates = {}
+    for port_name in sorted(os.listdir(PORTS_DIRECTORY)):
+        portfile = read_portfile(port_name)
+        if portfile is None or not BUILD_SYSTEM_REGEX.search(portfile) or DISQUALIFYING_REGEX.search(portfile):
+            continue
+        reasons = []
+        if RELEASE_ONLY_REGEX.search(portfile):
+            reasons.append('release only')
+        if HEADER_ONLY_REGEX.search(portfile):
+            reasons.append('marked header-only')
+        if reasons:
+            candidates[port_name] = reasons
+    return candidates
+
+
+def find_candidates_in_installed(installed_directory):
+    # Exact scan: every file the port installed is a header or lives in share/.
+    candidates = {}
+    for list_path in sorted(Path(installed_directory, 'vcpkg', 'info').glob('*.list')):
+        port_name = list_path.name.split('_')[0]
+        portfile = read_portfile(port_name)
+        if portfile is None or not BUILD_SYSTEM_REGEX.search(portfile):
+            continue
+        header_only = True
+        for line in list_path.read_text().splitlines():
+            _, _, installed_path = line.partition('/')
+            if not installed_path or installed_path.endswith('/'):
+                continue
+            if not (installed_path.startswith('include/') or installed_path.startswith('share/')):
+                header_only = False
+                break
+        if header_only:
+            candidates[port_name] = ['installs only headers and share files']
+    return candidates
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='List ports which install only headers but still configure a build system, '
+                    'and could use vcpkg_install_header_only instead.')
+    parser.add_argument('--installed', nargs='?', const=INSTALLED_DIRECTORY,
+                        help='Check the file lists of an installed tree instead of scanning portfiles.')
+    args = parser.parse_args()
+
+    if args.installed:
+        candidates = find_candidates_in_installed(args.installed)
+    else:
+        candidates = find_candidates_in_portfiles()
+    for port_name, reasons in sorted(candidates.items()):
+        note = ', '.join(reasons)
+        if port_name.startswith('boost-'):
+            note += '; set VCPKG_BOOST_FAST_HEADER_ONLY in the triplet'
+        print(f'{port_name}: {note}')
+    print(f'{len(candidates)} ports')
+
+
+if __name__ == "__main__":
+    main()
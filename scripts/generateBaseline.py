@@ -1,82 +1,203 @@
-import os
-import sys
-import json
-import time
-
-from pathlib import Path
-
-
-SCRIPT_DIRECTORY = os.path.dirname(os.path.abspath(__file__))
-PORTS_DIRECTORY = os.path.join(SCRIPT_DIRECTORY, '../ports')
-VERSIONS_DB_DIRECTORY = os.path.join(SCRIPT_DIRECTORY, '../versions')
-
-
-def get_version_tag(version):
-    if 'version' in version:
-        return version['version']
-    elif 'version-date' in version:
-        return version['version-date']
-    elif 'version-semver' in version:
-        return version['version-semver']
-    elif 'version-string' in version:
-        return version['version-string']
-    sys.exit(1)
-
-
-def get_version_port_version(version):
-    if 'port-version' in version:
-        return version['port-version']
-    return 0
-
-
-def generate_baseline():
-    start_time = time.time()
-
-    # Assume each directory in ${VCPKG_ROOT}/ports is a different port
-    port_names = [item for item in os.listdir(
-        PORTS_DIRECTORY) if os.path.isdir(os.path.join(PORTS_DIRECTORY, item))]
-    port_names.sort()
-
-    baseline_entries = {}
-    total_count = len(port_names)
-    for i, port_name in enumerate(port_names, 1):
-        port_file_path = os.path.join(
-            VERSIONS_DB_DIRECTORY, f'{port_name[0]}-', f'{port_name}.json')
-
-        if not os.path.exists(port_file_path):
-            print(
-                f'Error: No version file for {port_name}.\n', file=sys.stderr)
-            continue
-        sys.stderr.write(
-            f'\rProcessed {i}/{total_count} ({i/total_count:.2%})')
-        with open(port_file_path, 'r') as db_file:
-            try:
-                versions_object = json.load(db_file)
-                if versions_object['versions']:
-                    last_version = versions_object['versions'][0]
-                    baseline_entries[port_name] = {
-                        'baseline': get_version_tag(last_version),
-                        'port-version': get_version_port_version(last_version)
-                    }
-            except json.JSONDecodeError as e:
-                print(f'Error: Decoding {port_file_path}\n{e}\n')
-    baseline_object = {}
-    baseline_object['default'] = baseline_entries
-
-    os.makedirs(VERSIONS_DB_DIRECTORY, exist_ok=True)
-    baseline_path = os.path.join(VERSIONS_DB_DIRECTORY, 'baseline.json')
-    with open(baseline_path, 'w') as baseline_file:
-        json.dump(baseline_object, baseline_file)
-
-    elapsed_time = time.time() - start_time
-    print(f'\nElapsed time: {elapsed_time:.2f} seconds')
-
-
-def main():
-    if not os.path.exists(VERSIONS_DB_DIRECTORY):
-        print(f'Version DB files must exist before generating a baseline.\nRun: `python generatePortVersionsDB`\n')
-    generate_baseline()
-
-
-if __name__ == "__main__":
-    main()
+import os
+import sys
+import json
+import time
+import argparse
+import subprocess
+import multiprocessing
+
+from pathlib import Path
+from concurrent.futures import ProcessPoolExecutor
+
+
+MAX_PROCESSES = multiprocessing.cpu_count()
+SCRIPT_DIRECTORY = os.path.dirname(os.path.abspath(__file__))
+ROOT_DIRECTORY = os.path.normpath(os.path.join(SCRIPT_DIRECTORY, '..'))
+PORTS_DIRECTORY = os.path.join(SCRIPT_DIRECTORY, '../ports')
+VERSIONS_DB_DIRECTORY = os.path.join(SCRIPT_DIRECTORY, '../versions')
+# Baseline entry and git-tree of every versions file as of the last run, keyed by the file's mtime and size.
+CACHE_PATH = os.path.join(VERSIONS_DB_DIRECTORY, '.baseline-cache.json')
+CACHE_FORMAT = 1
+# Below this many changed files, starting worker processes costs more than it saves.
+PARALLEL_THRESHOLD = 256
+
+
+def get_version_tag(version):
+    if 'version' in version:
+        return version['version']
+    elif 'version-date' in version:
+        return version['version-date']
+    elif 'version-semver' in version:
+        return version['version-semver']
+    elif 'version-string' in version:
+        return version['version-string']
+    sys.exit(1)
+
+
+def get_version_port_version(version):
+    if 'port-version' in version:
+        return version['port-version']
+    return 0
+
+
+def read_versions_file(port_file_path):
+    """Returns (baseline entry, git-tree, error) for the newest version in a versions file."""
+    try:
+        with open(port_file_path, 'r') as db_file:
+            versions_object = json.load(db_file)
+    except (OSError, ValueError) as e:
+        return None, None, f'Decoding {port_file_path}\n{e}'
+    versions = versions_object.get('versions') if isinstance(versions_object, dict) else None
+    if not versions:
+        return None, None, f'{port_file_path} has no versions'
+    last_version = versions[0]
+    if not any(key in last_version for key in ('version', 'version-date', 'version-semver', 'version-string')):
+        return None, None, f'{port_file_path} has no version in its first entry'
+    baseline_entry = {
+        'baseline': get_version_tag(last_version),
+        'port-version': get_version_port_version(last_version)
+    }
+    return baseline_entry, last_version.get('git-tree'), None
+
+
+def read_versions_files(paths):
+    if len(paths) < PARALLEL_THRESHOLD:
+        return [read_versions_file(path) for path in paths]
+    with ProcessPoolExecutor(MAX_PROCESSES) as executor:
+        return list(executor.map(read_versions_file, paths, chunksize=64))
+
+
+def load_cache():
+    try:
+        with open(CACHE_PATH, 'r') as cache_file:
+            cache = json.load(cache_file)
+        if cache.get('format') == CACHE_FORMAT:
+            return cache['files']
+    except (OSError, ValueError, KeyError):
+        pass
+    return {}
+
+
+def get_port_trees():
+    """Returns {port: git-tree} of the port directories as staged in the git index."""
+    tree = subprocess.run(['git', '-C', ROOT_DIRECTORY, 'write-tree'], capture_output=True, encoding='utf-8')
+    if tree.returncode != 0:
+        print(f'Error: Failed to get the ports tree: {tree.stderr.strip()}', file=sys.stderr)
+        return None
+    output = subprocess.run(['git', '-C', ROOT_DIRECTORY, 'ls-tree', tree.stdout.strip(), 'ports/'],
+                            capture_output=True, encoding='utf-8', check=True)
+    port_trees = {}
+    for line in output.stdout.splitlines():
+        info, path = line.split('\t', 1)
+        if info.split()[1] == 'tree':
+            port_trees[Path(path).name] = info.split()[2]
+    return port_trees
+
+
+def generate_baseline(use_cache, validate, check_only):
+    start_time = time.time()
+
+    # Assume each directory in ${VCPKG_ROOT}/ports is a different port
+    port_names = [item for item in os.listdir(
+        PORTS_DIRECTORY) if os.path.isdir(os.path.join(PORTS_DIRECTORY, item))]
+    port_names.sort()
+
+    cache = load_cache() if use_cache else {}
+    new_cache = {}
+    stale = []
+    errors = 0
+    for port_name in port_names:
+        port_file_path = os.path.join(
+            VERSIONS_DB_DIRECTORY, f'{port_name[0]}-', f'{port_name}.json')
+        try:
+            stat = os.stat(port_file_path)
+        except FileNotFoundError:
+            print(f'Error: No version file for {port_name}.', file=sys.stderr)
+            errors += 1
+            continue
+        key = [stat.st_mtime_ns, stat.st_size]
+        cached = cache.get(port_name)
+        if cached and cached['key'] == key:
+            new_cache[port_name] = cached
+        else:
+            stale.append((port_name, port_file_path, key))
+
+    for (port_name, _, key), (baseline_entry, git_tree, error) in zip(
+            stale, read_versions_files([path for _, path, _ in stale])):
+        if error:
+            print(f'Error: {error}', file=sys.stderr)
+            errors += 1
+            continue
+        new_cache[port_name] = {'key': key, 'baseline': baseline_entry, 'git-tree': git_tree}
+
+    if validate:
+        port_trees = get_port_trees()
+        if port_trees is None:
+            errors += 1
+        else:
+            for port_name, entry in new_cache.items():
+                current_tree = port_trees.get(port_name)
+                if current_tree and entry['git-tree'] != current_tree:
+                    version = entry['baseline']
+                    print(f'Error: The git-tree of {port_name} {version["baseline"]}#{version["port-version"]} '
+                          f'is {entry["git-tree"]}, but ports/{port_name} is {current_tree}. '
+                          f'Run `vcpkg x-add-version {port_name}`.', file=sys.stderr)
+                    errors += 1
+
+    # Entries of ports which no longer have a directory are kept.
+    baseline_path = os.path.join(VERSIONS_DB_DIRECTORY, 'baseline.json')
+    baseline_entries = {}
+    if os.path.exists(baseline_path):
+        with open(baseline_path, 'r') as baseline_file:
+            try:
+                baseline_entries = json.load(baseline_file)['default']
+            except (ValueError, KeyError) as e:
+                print(f'Error: Decoding {baseline_path}\n{e}\n', file=sys.stderr)
+                baseline_entries = {}
+    updated = {port_name: entry['baseline'] for port_name, entry in new_cache.items()
+               if baseline_entries.get(port_name) != entry['baseline']}
+    baseline_entries.update(updated)
+    baseline_object = {}
+    baseline_object['default'] = dict(sorted(baseline_entries.items()))
+
+    if check_only:
+        if updated:
+            print(f'Error: baseline.json is out of date for {", ".join(sorted(updated))}', file=sys.stderr)
+            errors += 1
+    elif updated or not os.path.exists(baseline_path):
+        os.makedirs(VERSIONS_DB_DIRECTORY, exist_ok=True)
+        with open(baseline_path, 'w') as baseline_file:
+            json.dump(baseline_object, baseline_file, indent=2)
+            baseline_file.write('\n')
+    if stale or len(new_cache) != len(cache):
+        with open(CACHE_PATH, 'w') as cache_file:
+            json.dump({'format': CACHE_FORMAT, 'files': new_cache}, cache_file)
+
+    elapsed_time = time.time() - start_time
+    print(f'Read {len(stale)} of {len(port_names)} versions files, updated {len(updated)} baseline entries')
+    print(f'Elapsed time: {elapsed_time:.2f} seconds')
+    return errors
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Update versions/baseline.json from the newest entry of every port\'s versions file.')
+    parser.add_argument('--full', action='store_true',
+                        help='Read every versions file instead of only those changed since the last run.')
+    parser.add_argument('--no-validate', action='store_true',
+                        help='Do not check the git-trees against the ports directories staged in git.')
+    parser.add_argument('--check', action='store_true',
+                        help='Do not write baseline.json; fail if it is out of date.')
+    args = parser.parse_args()
+
+    if not os.path.exists(VERSIONS_DB_DIRECTORY):
+        print(f'Version DB files must exist before generating a baseline.\nRun: `python generatePortVersionsDB`\n')
+        sys.exit(1)
+    errors = generate_baseline(not args.full, not args.no_validate, args.check)
+    if errors:
+        print(f'{errors} errors', file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
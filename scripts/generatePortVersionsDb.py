@@ -1,87 +1,244 @@
-import os
-import sys
-import subprocess
-import json
-import time
-import shutil
-
-import multiprocessing
-
-from pathlib import Path
-
-
-MAX_PROCESSES = multiprocessing.cpu_count()
-SCRIPT_DIRECTORY = os.path.dirname(os.path.abspath(__file__))
-PORTS_DIRECTORY = os.path.join(SCRIPT_DIRECTORY, '../ports')
-VERSIONS_DB_DIRECTORY = os.path.join(SCRIPT_DIRECTORY, '../versions')
-
-
-def get_current_git_ref():
-    output = subprocess.run(['git', '-C', SCRIPT_DIRECTORY, 'rev-parse', '--verify', 'HEAD'],
-                            capture_output=True,
-                            encoding='utf-8')
-    if output.returncode == 0:
-        return output.stdout.strip()
-    print(f"Failed to get git ref:", output.stderr.strip(), file=sys.stderr)
-    return None
-
-
-def generate_versions_file(port_name):
-    containing_dir = os.path.join(VERSIONS_DB_DIRECTORY, f'{port_name[0]}-')
-    os.makedirs(containing_dir, exist_ok=True)
-
-    output_file_path = os.path.join(containing_dir, f'{port_name}.json')
-    if not os.path.exists(output_file_path):
-        env = os.environ.copy()
-        env['GIT_OPTIONAL_LOCKS'] = '0'
-        output = subprocess.run(
-            [os.path.join(SCRIPT_DIRECTORY, '../vcpkg'),
-             'x-history', port_name, '--x-json', f'--output={output_file_path}'],
-            capture_output=True, encoding='utf-8', env=env)
-        if output.returncode != 0:
-            print(f'x-history {port_name} failed: ',
-                  output.stdout.strip(), file=sys.stderr)
-
-
-def generate_versions_db(revision):
-    start_time = time.time()
-
-    # Assume each directory in ${VCPKG_ROOT}/ports is a different port
-    port_names = [item for item in os.listdir(
-        PORTS_DIRECTORY) if os.path.isdir(os.path.join(PORTS_DIRECTORY, item))]
-    total_count = len(port_names)
-
-    concurrency = MAX_PROCESSES / 2
-    print(f'Running {concurrency:.0f} parallel processes')
-    process_pool = multiprocessing.Pool(MAX_PROCESSES)
-    for i, _ in enumerate(process_pool.imap_unordered(generate_versions_file, port_names), 1):
-        sys.stderr.write(
-            f'\rProcessed: {i}/{total_count} ({(i / total_count):.2%})')
-    process_pool.close()
-    process_pool.join()
-
-    # Generate timestamp
-    rev_file = os.path.join(VERSIONS_DB_DIRECTORY, revision)
-    Path(rev_file).touch()
-
-    elapsed_time = time.time() - start_time
-    print(
-        f'\nElapsed time: {elapsed_time:.2f} seconds')
-
-
-def main():
-    revision = get_current_git_ref()
-    if not revision:
-        print('Couldn\'t fetch current Git revision', file=sys.stderr)
-        sys.exit(1)
-
-    rev_file = os.path.join(VERSIONS_DB_DIRECTORY, revision)
-    if os.path.exists(rev_file):
-        print(f'Database files already exist for commit {revision}')
-        sys.exit(0)
-
-    generate_versions_db(revision)
-
-
-if __name__ == "__main__":
-    main()
+import os
+import re
+import sys
+import json
+import time
+import argparse
+import subprocess
+
+from pathlib import Path
+
+
+SCRIPT_DIRECTORY = os.path.dirname(os.path.abspath(__file__))
+ROOT_DIRECTORY = os.path.normpath(os.path.join(SCRIPT_DIRECTORY, '..'))
+PORTS_DIRECTORY = os.path.join(SCRIPT_DIRECTORY, '../ports')
+VERSIONS_DB_DIRECTORY = os.path.join(SCRIPT_DIRECTORY, '../versions')
+
+VERSION_KEYS = ('version', 'version-semver', 'version-date', 'version-string')
+REVISION_REGEX = re.compile(r'^[0-9a-f]{40}$')
+# :<old mode> <new mode> <old object> <new object> <status>\t<path>
+RAW_DIFF_REGEX = re.compile(r'^:\d+ (\d+) [0-9a-f]+ ([0-9a-f]+) [A-Z]\d*\tports/([^/]+)$')
+NULL_OBJECT = '0' * 40
+
+
+def git(*args, **kwargs):
+    env = os.environ.copy()
+    env['GIT_OPTIONAL_LOCKS'] = '0'
+    return subprocess.run(['git', '-C', ROOT_DIRECTORY, *args], capture_output=True, encoding='utf-8', env=env, **kwargs)
+
+
+def get_current_git_ref():
+    output = git('rev-parse', '--verify', 'HEAD')
+    if output.returncode == 0:
+        return output.stdout.strip()
+    print(f"Failed to get git ref:", output.stderr.strip(), file=sys.stderr)
+    return None
+
+
+def find_stamp_revision(revision):
+    """Returns the most recent revision stamp in the versions directory which is an ancestor of revision."""
+    best = None
+    best_distance = None
+    for item in os.listdir(VERSIONS_DB_DIRECTORY):
+        if not REVISION_REGEX.match(item) or item == revision:
+            continue
+        if git('merge-base', '--is-ancestor', item, revision).returncode != 0:
+            continue
+        distance = int(git('rev-list', '--count', f'{item}..{revision}').stdout.strip())
+        if best is None or distance < best_distance:
+            best, best_distance = item, distance
+    return best
+
+
+def get_port_names_at(revision):
+    output = git('ls-tree', '--name-only', revision, 'ports/')
+    if output.returncode != 0:
+        return set()
+    return {Path(line).name for line in output.stdout.splitlines()}
+
+
+class ManifestReader:
+    """Reads port manifests out of tree objects through a single git cat-file process."""
+
+    def __init__(self):
+        self.process = subprocess.Popen(['git', '-C', ROOT_DIRECTORY, 'cat-file', '--batch'],
+                                        stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+
+    def read_blob(self, object_name):
+        self.process.stdin.write(f'{object_name}\n'.encode('utf-8'))
+        self.process.stdin.flush()
+        header = self.process.stdout.readline().decode('utf-8').split()
+        if len(header) != 3:
+            return None
+        contents = self.process.stdout.read(int(header[2]))
+        self.process.stdout.read(1)
+        return contents.decode('utf-8', errors='replace')
+
+    def read_version(self, tree):
+        """Returns (version key, version, port-version) of the port in tree, or None."""
+        manifest = self.read_blob(f'{tree}:vcpkg.json')
+        if manifest is not None:
+            try:
+                manifest = json.loads(manifest)
+            except ValueError:
+                return None
+            for key in VERSION_KEYS:
+                if key in manifest:
+                    return key, manifest[key], manifest.get('port-version', 0)
+            return None
+        control = self.read_blob(f'{tree}:CONTROL')
+        if control is None:
+            return None
+        fields = {}
+        # Only the first paragraph describes the port itself.
+        for line in control.split('\n\n', 1)[0].splitlines():
+            name, separator, value = line.partition(':')
+            if separator:
+                fields[name.strip().lower()] = value.strip()
+        if 'version' not in fields:
+            return None
+        return 'version-string', fields['version'], int(fields.get('port-version', '0') or '0')
+
+    def close(self):
+        self.process.stdin.close()
+        self.process.wait()
+
+
+def walk_port_history(revision_range, reader):
+    """Walks the first-parent history once, oldest commit first, and collects the distinct
+    tree objects each port directory had. Returns {port: [version entry, ...]}, newest first."""
+    commit_count = int(git('rev-list', '--count', '--first-parent', *revision_range, '--', 'ports/').stdout.strip())
+    process = subprocess.Popen(
+        ['git', '-C', ROOT_DIRECTORY, 'log', '--first-parent', '-m', '--root', '--reverse',
+         '--raw', '-t', '--no-renames', '--no-abbrev', '--format=commit %H', *revision_range, '--', 'ports/'],
+        stdout=subprocess.PIPE, encoding='utf-8')
+    history = {}
+    processed = 0
+    for line in process.stdout:
+        if line.startswith('commit '):
+            processed += 1
+            if commit_count:
+                sys.stderr.write(f'\rProcessed: {processed}/{commit_count} ({(processed / commit_count):.2%})')
+            continue
+        match = RAW_DIFF_REGEX.match(line.rstrip('\n'))
+        if not match:
+            continue
+        mode, tree, port_name = match.groups()
+        if mode != '040000' or tree == NULL_OBJECT:
+            continue
+        version = reader.read_version(tree)
+        if version is None:
+            continue
+        key, version_text, port_version = version
+        history.setdefault(port_name, []).append(
+            {'git-tree': tree, key: version_text, 'port-version': port_version})
+    if process.wait() != 0:
+        print('\ngit log failed', file=sys.stderr)
+        sys.exit(1)
+    if commit_count:
+        sys.stderr.write('\n')
+    return {port_name: merge_versions(entries[::-1], []) for port_name, entries in history.items()}
+
+
+def merge_versions(newer, older):
+    # A tree which comes back later keeps only its most recent entry.
+    seen = set()
+    merged = []
+    for entry in newer + older:
+        if entry['git-tree'] not in seen:
+            seen.add(entry['git-tree'])
+            merged.append(entry)
+    return merged
+
+
+def get_versions_file_path(port_name):
+    return os.path.join(VERSIONS_DB_DIRECTORY, f'{port_name[0]}-', f'{port_name}.json')
+
+
+def write_versions_file(port_name, versions):
+    output_file_path = get_versions_file_path(port_name)
+    os.makedirs(os.path.dirname(output_file_path), exist_ok=True)
+    with open(output_file_path, 'w') as output_file:
+        json.dump({'versions': versions}, output_file, indent=2)
+        output_file.write('\n')
+
+
+def generate_versions_db(revision, rebuild):
+    start_time = time.time()
+
+    # Assume each directory in ${VCPKG_ROOT}/ports is a different port
+    port_names = sorted(item for item in os.listdir(
+        PORTS_DIRECTORY) if os.path.isdir(os.path.join(PORTS_DIRECTORY, item)))
+
+    stamp_revision = None if rebuild else find_stamp_revision(revision)
+    reader = ManifestReader()
+    if stamp_revision:
+        # Ports which existed at the stamp and have a versions file only need the newer commits.
+        # Ports added since then are covered completely by the same walk.
+        ports_at_stamp = get_port_names_at(stamp_revision)
+        print(f'Updating from {stamp_revision}')
+        history = walk_port_history([f'{stamp_revision}..{revision}'], reader)
+        missing = [port_name for port_name in port_names
+                   if port_name in ports_at_stamp and not os.path.exists(get_versions_file_path(port_name))]
+        if missing:
+            print(f'{len(missing)} ports without versions file, walking the full history')
+            full_history = walk_port_history([revision], reader)
+            for port_name in missing:
+                history[port_name] = full_history.get(port_name, [])
+                ports_at_stamp.discard(port_name)
+    else:
+        ports_at_stamp = set()
+        history = walk_port_history([revision], reader)
+    reader.close()
+
+    written = 0
+    for port_name in port_names:
+        versions = history.get(port_name)
+        output_file_path = get_versions_file_path(port_name)
+        if not versions:
+            if not os.path.exists(output_file_path):
+                print(f'No versions found for {port_name}', file=sys.stderr)
+            continue
+        if port_name in ports_at_stamp and os.path.exists(output_file_path):
+            with open(output_file_path, 'r') as db_file:
+                versions = merge_versions(versions, json.load(db_file)['versions'])
+        elif os.path.exists(output_file_path) and not rebuild and not stamp_revision:
+            continue
+        write_versions_file(port_name, versions)
+        written += 1
+
+    # Generate timestamp
+    if stamp_revision:
+        os.remove(os.path.join(VERSIONS_DB_DIRECTORY, stamp_revision))
+    rev_file = os.path.join(VERSIONS_DB_DIRECTORY, revision)
+    Path(rev_file).touch()
+
+    elapsed_time = time.time() - start_time
+    print(f'Wrote {written} versions files')
+    print(
+        f'Elapsed time: {elapsed_time:.2f} seconds')
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Generate the versions database from the git history of the ports directory.')
+    parser.add_argument('--rebuild', action='store_true',
+                        help='Walk the full history and overwrite existing versions files instead of updating '
+                             'from the last processed revision.')
+    args = parser.parse_args()
+
+    revision = get_current_git_ref()
+    if not revision:
+        print('Couldn\'t fetch current Git revision', file=sys.stderr)
+        sys.exit(1)
+
+    rev_file = os.path.join(VERSIONS_DB_DIRECTORY, revision)
+    if os.path.exists(rev_file) and not args.rebuild:
+        print(f'Database files already exist for commit {revision}')
+        sys.exit(0)
+
+    generate_versions_db(revision, args.rebuild)
+
+
+if __name__ == "__main__":
+    main()
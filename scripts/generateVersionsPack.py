@@ -0,0 +1,302 @@
+import os
+import sys
+import json
+import mmap
+import time
+import random
+import struct
+import argparse
+
+from pathlib import Path
+
+
+SCRIPT_DIRECTORY = os.path.dirname(os.path.abspath(__file__))
+VERSIONS_DB_DIRECTORY = os.path.join(SCRIPT_DIRECTORY, '../versions')
+DEFAULT_PACK_PATH = os.path.join(VERSIONS_DB_DIRECTORY, 'versions.pack')
+
+# Layout, all integers little endian:
+#   header
+#   port records, sorted by the UTF-8 bytes of the port name
+#   version records, grouped by port, in the order of the versions file (newest first)
+#   git-tree hashes, 20 bytes per version record
+#   string table, UTF-8 strings referenced by (offset, length)
+MAGIC = b'VCPKGVP\0'
+FORMAT_VERSION = 1
+# magic, format version, port count, version count, offsets of the four sections
+HEADER = struct.Struct('<8sIIIIIII')
+# name offset, name length, flags, baseline offset, baseline length, baseline port-version,
+# first version record, version record count
+PORT_RECORD = struct.Struct('<IHHIHxxIII')
+# version offset, version length, scheme, flags, port-version
+VERSION_RECORD = struct.Struct('<IHBBI')
+TREE_SIZE = 20
+
+PORT_HAS_BASELINE = 1
+PORT_HAS_VERSIONS = 2
+VERSION_HAS_PORT_VERSION = 1
+SCHEMES = ('version', 'version-semver', 'version-date', 'version-string')
+
+
+class StringTable:
+    def __init__(self):
+        self.data = bytearray()
+        self.offsets = {}
+
+    def add(self, text):
+        encoded = text.encode('utf-8')
+        if len(encoded) > 0xFFFF:
+            raise ValueError(f'String too long for the pack: {text[:40]}...')
+        if encoded not in self.offsets:
+            self.offsets[encoded] = len(self.data)
+            self.data += encoded
+        return self.offsets[encoded], len(encoded)
+
+
+def load_versions_db(versions_directory):
+    """Returns (baseline entries, {port: versions}) as read from the JSON files."""
+    with open(os.path.join(versions_directory, 'baseline.json'), 'r') as baseline_file:
+        baseline_object = json.load(baseline_file)
+    if list(baseline_object.keys()) != ['default']:
+        raise ValueError('baseline.json must only contain the "default" baseline')
+    versions = {}
+    for port_file_path in Path(versions_directory).glob('*-/*.json'):
+        with open(port_file_path, 'r') as db_file:
+            versions[port_file_path.stem] = json.load(db_file)['versions']
+    return baseline_object['default'], versions
+
+
+def encode_version(entry, strings):
+    unknown = set(entry) - {'git-tree', 'port-version', *SCHEMES}
+    schemes = [scheme for scheme in SCHEMES if scheme in entry]
+    if unknown or len(schemes) != 1:
+        raise ValueError(f'Unsupported versions entry: {entry}')
+    offset, length = strings.add(entry[schemes[0]])
+    flags = VERSION_HAS_PORT_VERSION if 'port-version' in entry else 0
+    return VERSION_RECORD.pack(offset, length, SCHEMES.index(schemes[0]), flags, entry.get('port-version', 0)), \
+        bytes.fromhex(entry['git-tree'])
+
+
+def build_pack(baseline, versions):
+    strings = StringTable()
+    port_records = bytearray()
+    version_records = bytearray()
+    trees = bytearray()
+    version_count = 0
+    for port_name in sorted(set(baseline) | set(versions), key=lambda name: name.encode('utf-8')):
+        name_offset, name_length = strings.add(port_name)
+        flags = 0
+        baseline_offset, baseline_length, baseline_port_version = 0, 0, 0
+        if port_name in baseline:
+            entry = baseline[port_name]
+            if set(entry) != {'baseline', 'port-version'}:
+                raise ValueError(f'Unsupported baseline entry for {port_name}: {entry}')
+            flags |= PORT_HAS_BASELINE
+            baseline_offset, baseline_length = strings.add(entry['baseline'])
+            baseline_port_version = entry['port-version']
+        first_version = version_count
+        if port_name in versions:
+            flags |= PORT_HAS_VERSIONS
+            for entry in versions[port_name]:
+                record, tree = encode_version(entry, strings)
+                version_records += record
+                trees += tree
+                version_count += 1
+        port_records += PORT_RECORD.pack(name_offset, name_length, flags, baseline_offset, baseline_length,
+                                         baseline_port_version, first_version, version_count - first_version)
+
+    port_count = len(port_records) // PORT_RECORD.size
+    ports_offset = HEADER.size
+    versions_offset = ports_offset + len(port_records)
+    trees_offset = versions_offset + len(version_records)
+    strings_offset = trees_offset + len(trees)
+    header = HEADER.pack(MAGIC, FORMAT_VERSION, port_count, version_count,
+                         ports_offset, versions_offset, trees_offset, strings_offset)
+    return header + port_records + version_records + trees + strings.data
+
+
+class VersionsPack:
+    """Reads a versions pack through mmap; ports are found by binary search over the sorted records."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as pack_file:
+            self.data = mmap.mmap(pack_file.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, format_version, self.port_count, self.version_count, self.ports_offset, \
+            self.versions_offset, self.trees_offset, self.strings_offset = HEADER.unpack_from(self.data)
+        if magic != MAGIC or format_version != FORMAT_VERSION:
+            raise ValueError(f'{path} is not a versions pack of format {FORMAT_VERSION}')
+
+    def close(self):
+        self.data.close()
+
+    def _string(self, offset, length):
+        start = self.strings_offset + offset
+        return self.data[start:start + length]
+
+    def _port_record(self, index):
+        return PORT_RECORD.unpack_from(self.data, self.ports_offset + index * PORT_RECORD.size)
+
+    def _find(self, port_name):
+        key = port_name.encode('utf-8')
+        low, high = 0, self.port_count
+        while low < high:
+            middle = (low + high) // 2
+            record = self._port_record(middle)
+            name = self._string(record[0], record[1])
+            if name < key:
+                low = middle + 1
+            elif name > key:
+                high = middle
+            else:
+                return record
+        return None
+
+    def port_names(self):
+        for index in range(self.port_count):
+            record = self._port_record(index)
+            yield self._string(record[0], record[1]).decode('utf-8')
+
+    def baseline(self, port_name):
+        """Returns the baseline entry of a port as in baseline.json, or None."""
+        record = self._find(port_name)
+        if record is None or not record[2] & PORT_HAS_BASELINE:
+            return None
+        return {'baseline': self._string(record[3], record[4]).decode('utf-8'), 'port-version': record[5]}
+
+    def _version(self, index):
+        offset, length, scheme, flags, port_version = VERSION_RECORD.unpack_from(
+            self.data, self.versions_offset + index * VERSION_RECORD.size)
+        tree_start = self.trees_offset + index * TREE_SIZE
+        entry = {'git-tree': self.data[tree_start:tree_start + TREE_SIZE].hex(),
+                 SCHEMES[scheme]: self._string(offset, length).decode('utf-8')}
+        if flags & VERSION_HAS_PORT_VERSION:
+            entry['port-version'] = port_version
+        return entry
+
+    def versions(self, port_name):
+        """Returns the entries of a port's versions file, or None."""
+        record = self._find(port_name)
+        if record is None or not record[2] & PORT_HAS_VERSIONS:
+            return None
+        return [self._version(index) for index in range(record[6], record[6] + record[7])]
+
+    def git_tree(self, port_name, version, port_version):
+        """Returns the git-tree of a port at a version, as version resolution needs it."""
+        record = self._find(port_name)
+        if record is None:
+            return None
+        key = version.encode('utf-8')
+        for index in range(record[6], record[6] + record[7]):
+            offset, length, _, _, entry_port_version = VERSION_RECORD.unpack_from(
+                self.data, self.versions_offset + index * VERSION_RECORD.size)
+            if entry_port_version == port_version and self._string(offset, length) == key:
+                tree_start = self.trees_offset + index * TREE_SIZE
+                return self.data[tree_start:tree_start + TREE_SIZE].hex()
+        return None
+
+
+def json_git_tree(versions_directory, baseline, port_name):
+    """The lookup the benchmark compares against: baseline entry, then the port's versions file."""
+    entry = baseline.get(port_name)
+    if entry is None:
+        return None
+    with open(os.path.join(versions_directory, f'{port_name[0]}-', f'{port_name}.json'), 'r') as db_file:
+        for version in json.load(db_file)['versions']:
+            if version.get('port-version', 0) == entry['port-version'] and \
+                    any(version.get(scheme) == entry['baseline'] for scheme in SCHEMES):
+                return version['git-tree']
+    return None
+
+
+def generate(args):
+    start_time = time.time()
+    baseline, versions = load_versions_db(args.versions)
+    pack = build_pack(baseline, versions)
+    with open(args.pack, 'wb') as pack_file:
+        pack_file.write(pack)
+    elapsed_time = time.time() - start_time
+    print(f'Wrote {args.pack}: {len(set(baseline) | set(versions))} ports, {len(pack)} bytes')
+    print(f'Elapsed time: {elapsed_time:.2f} seconds')
+
+
+def verify(args):
+    baseline, versions = load_versions_db(args.versions)
+    pack = VersionsPack(args.pack)
+    errors = 0
+    port_names = set(baseline) | set(versions)
+    packed_names = list(pack.port_names())
+    if packed_names != sorted(packed_names, key=lambda name: name.encode('utf-8')):
+        print('Error: port records are not sorted', file=sys.stderr)
+        errors += 1
+    if set(packed_names) != port_names:
+        print(f'Error: ports differ: {sorted(set(packed_names) ^ port_names)}', file=sys.stderr)
+        errors += 1
+    for port_name in sorted(port_names):
+        if pack.baseline(port_name) != baseline.get(port_name):
+            print(f'Error: baseline of {port_name} differs', file=sys.stderr)
+            errors += 1
+        if pack.versions(port_name) != versions.get(port_name):
+            print(f'Error: versions of {port_name} differ', file=sys.stderr)
+            errors += 1
+    pack.close()
+    if errors:
+        print(f'{args.pack} does not match {args.versions}: {errors} errors', file=sys.stderr)
+        sys.exit(1)
+    print(f'{args.pack} matches {len(port_names)} ports in {args.versions}')
+
+
+def benchmark(args):
+    with open(os.path.join(args.versions, 'baseline.json'), 'r') as baseline_file:
+        port_names = sorted(json.load(baseline_file)['default'])
+    port_names = [name for name in port_names
+                  if os.path.exists(os.path.join(args.versions, f'{name[0]}-', f'{name}.json'))]
+    random.seed(0)
+    lookups = [random.choice(port_names) for _ in range(args.lookups)]
+
+    # Each resolution starts from scratch, as a vcpkg invocation would.
+    start_time = time.perf_counter()
+    json_trees = []
+    for port_name in lookups:
+        with open(os.path.join(args.versions, 'baseline.json'), 'r') as baseline_file:
+            baseline = json.load(baseline_file)['default']
+        json_trees.append(json_git_tree(args.versions, baseline, port_name))
+    json_time = time.perf_counter() - start_time
+
+    start_time = time.perf_counter()
+    pack_trees = []
+    for port_name in lookups:
+        pack = VersionsPack(args.pack)
+        entry = pack.baseline(port_name)
+        pack_trees.append(pack.git_tree(port_name, entry['baseline'], entry['port-version']))
+        pack.close()
+    pack_time = time.perf_counter() - start_time
+
+    if json_trees != pack_trees:
+        print('Error: JSON and pack lookups disagree', file=sys.stderr)
+        sys.exit(1)
+    print(f'{args.lookups} baseline git-tree lookups')
+    print(f'  JSON: {json_time * 1000 / args.lookups:.3f} ms per lookup, 2 files opened')
+    print(f'  pack: {pack_time * 1000 / args.lookups:.3f} ms per lookup, 1 file mapped')
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Generate, verify and benchmark a binary pack of versions/baseline.json and the versions files.')
+    parser.add_argument('--versions', default=VERSIONS_DB_DIRECTORY, help='Versions database directory.')
+    parser.add_argument('--pack', default=DEFAULT_PACK_PATH, help='Pack file.')
+    subparsers = parser.add_subparsers(dest='command')
+    subparsers.add_parser('generate', help='Write the pack (default).')
+    subparsers.add_parser('verify', help='Check that the pack is equivalent to the JSON files.')
+    benchmark_parser = subparsers.add_parser('benchmark', help='Compare baseline git-tree lookups.')
+    benchmark_parser.add_argument('--lookups', type=int, default=1000)
+    args = parser.parse_args()
+
+    if args.command == 'verify':
+        verify(args)
+    elif args.command == 'benchmark':
+        benchmark(args)
+    else:
+        generate(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,196 @@
+import os
+import re
+import sys
+import json
+import hashlib
+import argparse
+import subprocess
+
+from pathlib import Path
+
+
+SCRIPT_DIRECTORY = os.path.dirname(os.path.abspath(__file__))
+ROOT_DIRECTORY = os.path.normpath(os.path.join(SCRIPT_DIRECTORY, '..'))
+PORTS_DIRECTORY = os.path.join(ROOT_DIRECTORY, 'ports')
+
+# Executed by scripts/ports.cmake for every port; a change here affects all ports.
+ALWAYS_USED_FILES = {
+    'scripts/ports.cmake',
+    'scripts/build_info.cmake',
+    'scripts/cmake/vcpkg_common_definitions.cmake',
+}
+
+DEFINITION_REGEX = re.compile(r'^[ \t]*(?:function|macro)[ \t]*\([ \t]*([A-Za-z0-9_]+)', re.MULTILINE | re.IGNORECASE)
+CALL_REGEX = re.compile(r'\b([A-Za-z_][A-Za-z0-9_]*)[ \t]*\(')
+HELPER_PORT_REGEX = re.compile(r'\bVCPKG_POLICY_CMAKE_HELPER_PORT\b')
+# Data files included by the helper of the same name, e.g. vcpkg_find_acquire_program(NINJA).cmake
+DATA_FILE_REGEX = re.compile(r'^(.*)\([A-Za-z0-9_]+\)\.cmake$')
+
+
+def read_text(path):
+    with open(path, 'r', encoding='utf-8', errors='replace') as file:
+        return file.read()
+
+
+def relative_path(path):
+    return Path(os.path.relpath(path, ROOT_DIRECTORY)).as_posix()
+
+
+def is_helper_port(port_name, portfile):
+    return port_name.startswith('vcpkg-') or HELPER_PORT_REGEX.search(portfile) is not None
+
+
+class HelperGraph:
+    """Static approximation of which helper files a port executes."""
+
+    def __init__(self):
+        self.definitions = {}
+        self.helper_files = {}
+        self.data_files = {}
+        for path in Path(ROOT_DIRECTORY, 'scripts', 'cmake').glob('*.cmake'):
+            self.add_helper_file(path)
+        self.add_helper_file(Path(ROOT_DIRECTORY, 'scripts', 'ports.cmake'))
+        for port_name in sorted(os.listdir(PORTS_DIRECTORY)):
+            portfile_path = os.path.join(PORTS_DIRECTORY, port_name, 'portfile.cmake')
+            if os.path.exists(portfile_path) and is_helper_port(port_name, read_text(portfile_path)):
+                for path in Path(PORTS_DIRECTORY, port_name).glob('*.cmake'):
+                    if path.name != 'portfile.cmake':
+                        self.add_helper_file(path)
+        self.closures = {}
+
+    def add_helper_file(self, path):
+        text = read_text(path)
+        name = relative_path(path)
+        self.helper_files[name] = text
+        data_file_match = DATA_FILE_REGEX.match(name)
+        if data_file_match:
+            self.data_files.setdefault(data_file_match.group(1) + '.cmake', set()).add(name)
+        for function_name in DEFINITION_REGEX.findall(text):
+            self.definitions.setdefault(function_name.lower(), name)
+
+    def called_files(self, text):
+        files = set()
+        for function_name in CALL_REGEX.findall(text):
+            defining_file = self.definitions.get(function_name.lower())
+            if defining_file:
+                files.add(defining_file)
+        return files
+
+    def closure(self, name):
+        if name not in self.closures:
+            self.closures[name] = {name}
+            pending = [name]
+            while pending:
+                current = pending.pop()
+                for called in self.called_files(self.helper_files[current]) | self.data_files.get(current, set()):
+                    if called not in self.closures[name]:
+                        self.closures[name].add(called)
+                        pending.append(called)
+        return self.closures[name]
+
+    def port_files(self, port_name):
+        text = ''.join(read_text(path) for path in Path(PORTS_DIRECTORY, port_name).glob('*.cmake'))
+        files = set(ALWAYS_USED_FILES)
+        for called in self.called_files(text):
+            files |= self.closure(called)
+        return files
+
+
+def affected_ports(graph, changed, port_names, manifests):
+    """Returns (ports which use any of the changed helper files, changed files no port is known to use).
+
+    Recorded manifests take precedence over the static graph. The caller should treat the files of
+    the second set as affecting every port."""
+    recorded_ports = {port for port, _ in manifests}
+    used = set(ALWAYS_USED_FILES)
+    affected = set()
+    for (port, _), manifest in manifests.items():
+        used |= set(manifest['files'])
+        if changed & set(manifest['files']):
+            affected.add(port)
+    for port_name in port_names:
+        files = graph.port_files(port_name)
+        used |= files
+        if port_name not in recorded_ports and changed & files:
+            affected.add(port_name)
+    unmapped = {path for path in changed - used if path.startswith('scripts/')}
+    return affected, unmapped
+
+
+def load_manifests(buildtrees_directory):
+    manifests = {}
+    for manifest_path in Path(buildtrees_directory).glob('*/helper-usage-*.json'):
+        manifest = json.loads(manifest_path.read_text())
+        manifests[(manifest['port'], manifest['triplet'])] = manifest
+    return manifests
+
+
+def changed_files_since(revision):
+    output = subprocess.check_output(
+        ['git', 'diff', '--name-only', revision, '--', 'scripts', 'ports'], cwd=ROOT_DIRECTORY, text=True)
+    return output.splitlines()
+
+
+def helper_key(manifest):
+    # The part of a package ABI contributed by the helpers it executed.
+    lines = ''.join(f'{path} {file_hash}\n' for path, file_hash in sorted(manifest['files'].items()))
+    return hashlib.sha256(lines.encode('utf-8')).hexdigest()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Report which helper scripts ports execute, and which ports a helper change affects.')
+    parser.add_argument('--buildtrees', default=os.path.join(ROOT_DIRECTORY, 'buildtrees'),
+                        help='Directory with helper-usage-<triplet>.json manifests recorded with VCPKG_RECORD_HELPER_USAGE.')
+    subparsers = parser.add_subparsers(dest='command', required=True)
+    affected_parser = subparsers.add_parser('affected', help='List ports which use any of the given helper files.')
+    affected_parser.add_argument('files', nargs='*', help='Helper files relative to the vcpkg root.')
+    affected_parser.add_argument('--since', help='Use the helper files changed since this git revision.')
+    affected_parser.add_argument('--static-only', action='store_true', help='Ignore recorded manifests.')
+    uses_parser = subparsers.add_parser('uses', help='List the helper files a port uses.')
+    uses_parser.add_argument('port')
+    subparsers.add_parser('keys', help='Print the helper key of every recorded manifest.')
+    args = parser.parse_args()
+
+    manifests = {} if getattr(args, 'static_only', False) else load_manifests(args.buildtrees)
+    recorded_ports = {port for port, _ in manifests}
+
+    if args.command == 'keys':
+        for (port, triplet), manifest in sorted(manifests.items()):
+            print(f'{port}:{triplet} {helper_key(manifest)}')
+        return
+
+    graph = HelperGraph()
+    if args.command == 'uses':
+        recorded = [manifest for (port, _), manifest in manifests.items() if port == args.port]
+        if recorded:
+            files = set().union(*(manifest['files'] for manifest in recorded))
+        else:
+            files = graph.port_files(args.port)
+        for path in sorted(files):
+            print(path)
+        return
+
+    changed = set(args.files)
+    if args.since:
+        changed |= set(changed_files_since(args.since))
+    changed &= set(graph.helper_files) | ALWAYS_USED_FILES
+    if not changed:
+        print('No helper files changed', file=sys.stderr)
+        return
+    if changed & ALWAYS_USED_FILES:
+        print(f'{", ".join(sorted(changed & ALWAYS_USED_FILES))} affects all ports', file=sys.stderr)
+
+    port_names = [port_name for port_name in sorted(os.listdir(PORTS_DIRECTORY))
+                  if os.path.exists(os.path.join(PORTS_DIRECTORY, port_name, 'portfile.cmake'))]
+    affected, unmapped = affected_ports(graph, changed, port_names, manifests)
+    if unmapped:
+        print(f'{", ".join(sorted(unmapped))} is not known to be used by any port and affects all ports', file=sys.stderr)
+        affected = set(port_names)
+    for port_name in sorted(affected):
+        print(port_name)
+    print(f'{len(affected)} ports affected, {len(recorded_ports & affected)} from recorded manifests', file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
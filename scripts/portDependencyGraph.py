@@ -0,0 +1,412 @@
+import os
+import re
+import sys
+import json
+import time
+import argparse
+import subprocess
+
+from pathlib import Path
+
+
+SCRIPT_DIRECTORY = os.path.dirname(os.path.abspath(__file__))
+ROOT_DIRECTORY = os.path.normpath(os.path.join(SCRIPT_DIRECTORY, '..'))
+PORTS_DIRECTORY = os.path.join(ROOT_DIRECTORY, 'ports')
+TRIPLETS_DIRECTORY = os.path.join(ROOT_DIRECTORY, 'triplets')
+CI_BASELINE_PATH = os.path.join(SCRIPT_DIRECTORY, 'ci.baseline.txt')
+# Dependency information of every manifest as of the last run, keyed by the manifest's mtime and size.
+CACHE_PATH = os.path.join(ROOT_DIRECTORY, 'buildtrees', '.port-graph-cache.json')
+CACHE_FORMAT = 1
+
+# Changes to these never change what a port builds.
+NO_BUILD_IMPACT_REGEX = re.compile(
+    r'^(versions/|docs/|\.github/|scripts/azure-pipelines/|scripts/[^/]+\.py$|scripts/ci\.[^/]+\.txt$|[^/]+\.md$|'
+    r'scripts/test_ports/|LICENSE\.txt$|NOTICE\.txt$|\.gitignore$)')
+CI_BASELINE_REGEX = re.compile(r'^([a-z0-9-]+):([a-z0-9-]+)\s*=\s*(fail|skip|pass)\s*(#.*)?$')
+
+
+class PlatformExpression:
+    """A parsed platform expression: identifiers combined with !, &, | and parentheses (',' is an older '|')."""
+
+    TOKEN_REGEX = re.compile(r'\s*(?:([a-z0-9-]+)|(.))')
+
+    def __init__(self, text):
+        self.text = text
+        self.tokens = [match.group(1) or match.group(2) for match in self.TOKEN_REGEX.finditer(text)
+                       if match.group(1) or (match.group(2) and not match.group(2).isspace())]
+        self.position = 0
+        self.tree = self._parse_or() if self.tokens else ('true',)
+        if self.position != len(self.tokens):
+            raise ValueError(f'Invalid platform expression: {text}')
+        del self.tokens
+
+    def _peek(self):
+        return self.tokens[self.position] if self.position < len(self.tokens) else None
+
+    def _parse_or(self):
+        operands = [self._parse_and()]
+        while self._peek() in ('|', ','):
+            self.position += 1
+            operands.append(self._parse_and())
+        return operands[0] if len(operands) == 1 else ('or', *operands)
+
+    def _parse_and(self):
+        operands = [self._parse_unary()]
+        while self._peek() == '&':
+            self.position += 1
+            operands.append(self._parse_unary())
+        return operands[0] if len(operands) == 1 else ('and', *operands)
+
+    def _parse_unary(self):
+        token = self._peek()
+        self.position += 1
+        if token == '!':
+            return ('not', self._parse_unary())
+        if token == '(':
+            result = self._parse_or()
+            if self._peek() != ')':
+                raise ValueError(f'Invalid platform expression: {self.text}')
+            self.position += 1
+            return result
+        if token is None or not re.match(r'^[a-z0-9-]+$', token):
+            raise ValueError(f'Invalid platform expression: {self.text}')
+        return ('id', token)
+
+    def evaluate(self, identifiers, node=None):
+        node = node or self.tree
+        if node[0] == 'id':
+            return node[1] in identifiers
+        if node[0] == 'not':
+            return not self.evaluate(identifiers, node[1])
+        if node[0] == 'and':
+            return all(self.evaluate(identifiers, operand) for operand in node[1:])
+        if node[0] == 'or':
+            return any(self.evaluate(identifiers, operand) for operand in node[1:])
+        return True
+
+
+def read_triplet_variables(triplet):
+    for directory in (TRIPLETS_DIRECTORY, os.path.join(TRIPLETS_DIRECTORY, 'community')):
+        path = os.path.join(directory, f'{triplet}.cmake')
+        if os.path.exists(path):
+            with open(path, 'r') as triplet_file:
+                return dict(re.findall(r'^\s*set\(\s*(VCPKG_[A-Z_]+)\s+"?([^")\s]*)"?\s*\)', triplet_file.read(), re.MULTILINE))
+    raise ValueError(f'Unknown triplet {triplet}')
+
+
+def get_triplet_identifiers(triplet, host_triplet):
+    """The platform expression identifiers which are true for a triplet."""
+    variables = read_triplet_variables(triplet)
+    architecture = variables.get('VCPKG_TARGET_ARCHITECTURE', '')
+    system_name = variables.get('VCPKG_CMAKE_SYSTEM_NAME', '')
+    identifiers = set()
+    if architecture in ('x86', 'x64', 'arm64', 'arm64ec', 'wasm32'):
+        identifiers.add(architecture)
+    if architecture in ('arm', 'arm64', 'arm64ec'):
+        identifiers.add('arm')
+    if architecture == 'arm':
+        identifiers.add('arm32')
+    systems = {'': 'windows', 'WindowsStore': 'uwp', 'MinGW': 'mingw', 'Linux': 'linux', 'Darwin': 'osx',
+               'iOS': 'ios', 'tvOS': 'tvos', 'watchOS': 'watchos', 'visionOS': 'visionos', 'Android': 'android',
+               'Emscripten': 'emscripten', 'FreeBSD': 'freebsd', 'OpenBSD': 'openbsd', 'NetBSD': 'netbsd',
+               'QNX': 'qnx'}
+    if system_name in systems:
+        identifiers.add(systems[system_name])
+    if system_name in ('', 'WindowsStore', 'MinGW'):
+        identifiers.add('windows')
+    if system_name in ('FreeBSD', 'OpenBSD', 'NetBSD'):
+        identifiers.add('bsd')
+    if 'VCPKG_XBOX_CONSOLE_TARGET' in variables:
+        identifiers.add('xbox')
+    if variables.get('VCPKG_LIBRARY_LINKAGE') == 'static':
+        identifiers.add('static')
+    if variables.get('VCPKG_CRT_LINKAGE') == 'static':
+        identifiers.add('staticcrt')
+    if triplet == host_triplet:
+        identifiers.add('native')
+    return frozenset(identifiers)
+
+
+def reduce_dependencies(dependencies):
+    reduced = []
+    for dependency in dependencies:
+        if isinstance(dependency, str):
+            dependency = {'name': dependency}
+        features = [feature if isinstance(feature, str) else [feature['name'], feature.get('platform', '')]
+                    for feature in dependency.get('features', [])]
+        reduced.append([dependency['name'], dependency.get('host', False), dependency.get('platform', ''),
+                        dependency.get('default-features', True), features])
+    return reduced
+
+
+def reduce_manifest(manifest):
+    """The parts of a manifest which determine the dependency graph."""
+    default_features = [feature if isinstance(feature, str) else [feature['name'], feature.get('platform', '')]
+                        for feature in manifest.get('default-features', [])]
+    features = {name: [feature.get('supports', ''), reduce_dependencies(feature.get('dependencies', []))]
+                for name, feature in manifest.get('features', {}).items()}
+    return {'supports': manifest.get('supports', ''), 'dependencies': reduce_dependencies(manifest.get('dependencies', [])),
+            'default-features': default_features, 'features': features}
+
+
+def load_manifests(use_cache=True):
+    """Returns {port: reduced manifest}, reading only the manifests changed since the cache was written."""
+    cache = {}
+    if use_cache:
+        try:
+            with open(CACHE_PATH, 'r') as cache_file:
+                cache_object = json.load(cache_file)
+            if cache_object.get('format') == CACHE_FORMAT:
+                cache = cache_object['ports']
+        except (OSError, ValueError, KeyError):
+            pass
+    ports = {}
+    changed = False
+    for entry in os.scandir(PORTS_DIRECTORY):
+        try:
+            stat = os.stat(os.path.join(entry.path, 'vcpkg.json'))
+        except (FileNotFoundError, NotADirectoryError):
+            continue
+        key = [stat.st_mtime_ns, stat.st_size]
+        cached = cache.get(entry.name)
+        if cached and cached['key'] == key:
+            ports[entry.name] = cached
+            continue
+        with open(os.path.join(entry.path, 'vcpkg.json'), 'r', encoding='utf-8') as manifest_file:
+            ports[entry.name] = {'key': key, 'manifest': reduce_manifest(json.load(manifest_file))}
+        changed = True
+    if changed or len(ports) != len(cache):
+        os.makedirs(os.path.dirname(CACHE_PATH), exist_ok=True)
+        with open(CACHE_PATH, 'w') as cache_file:
+            json.dump({'format': CACHE_FORMAT, 'ports': ports}, cache_file)
+    return {name: port['manifest'] for name, port in ports.items()}
+
+
+class PortGraph:
+    """The feature-level dependency graph of all ports for one target triplet and its host triplet.
+
+    Nodes are (port, feature, triplet); 'core' stands for the port without features and
+    'default' for its default features. A node's edges lead to everything it needs installed."""
+
+    def __init__(self, manifests, triplet, host_triplet):
+        self.manifests = manifests
+        self.triplet = triplet
+        self.host_triplet = host_triplet
+        self.identifiers = {triplet: get_triplet_identifiers(triplet, host_triplet)}
+        self.identifiers[host_triplet] = get_triplet_identifiers(host_triplet, host_triplet)
+        self.expressions = {}
+        self.edges = {}
+        for port_name in manifests:
+            for node_triplet in {triplet, host_triplet}:
+                self._add_port(port_name, node_triplet)
+        self.reverse_edges = {}
+        for node, targets in self.edges.items():
+            for target in targets:
+                self.reverse_edges.setdefault(target, []).append(node)
+
+    def is_active(self, expression, triplet):
+        if not expression:
+            return True
+        if expression not in self.expressions:
+            self.expressions[expression] = PlatformExpression(expression)
+        return self.expressions[expression].evaluate(self.identifiers[triplet])
+
+    def _dependency_nodes(self, dependencies, triplet):
+        nodes = []
+        for name, host, platform, default_features, features in dependencies:
+            if not self.is_active(platform, triplet):
+                continue
+            dependency_triplet = self.host_triplet if host else triplet
+            nodes.append((name, 'core', dependency_triplet))
+            if default_features:
+                nodes.append((name, 'default', dependency_triplet))
+            for feature in features:
+                if isinstance(feature, str):
+                    nodes.append((name, feature, dependency_triplet))
+                elif self.is_active(feature[1], triplet):
+                    nodes.append((name, feature[0], dependency_triplet))
+        return nodes
+
+    def _add_port(self, port_name, triplet):
+        manifest = self.manifests[port_name]
+        self.edges[(port_name, 'core', triplet)] = self._dependency_nodes(manifest['dependencies'], triplet)
+        default_nodes = [(port_name, 'core', triplet)]
+        for feature in manifest['default-features']:
+            if isinstance(feature, str):
+                default_nodes.append((port_name, feature, triplet))
+            elif self.is_active(feature[1], triplet):
+                default_nodes.append((port_name, feature[0], triplet))
+        self.edges[(port_name, 'default', triplet)] = default_nodes
+        for feature, (_, dependencies) in manifest['features'].items():
+            self.edges[(port_name, feature, triplet)] = \
+                [(port_name, 'core', triplet)] + self._dependency_nodes(dependencies, triplet)
+
+    def is_supported(self, port_name, feature, triplet):
+        manifest = self.manifests.get(port_name)
+        if manifest is None or not self.is_active(manifest['supports'], triplet):
+            return False
+        if feature in ('core', 'default'):
+            return True
+        return feature in manifest['features'] and self.is_active(manifest['features'][feature][0], triplet)
+
+    def impacted_nodes(self, changed_ports):
+        """All nodes which need one of the changed ports, directly or transitively."""
+        pending = [node for node in self.edges if node[0] in changed_ports]
+        impacted = set(pending)
+        while pending:
+            for dependent in self.reverse_edges.get(pending.pop(), ()):
+                if dependent not in impacted:
+                    impacted.add(dependent)
+                    pending.append(dependent)
+        return impacted
+
+    def is_blocked(self, node, port_state, memo):
+        """Whether a node or anything it needs has a port_state; memo is shared between calls."""
+        if node not in memo:
+            # Features of a port lead back to its core; the provisional answer breaks that cycle.
+            memo[node] = False
+            memo[node] = port_state(node[0], node[2]) is not None or \
+                any(self.is_blocked(target, port_state, memo) for target in self.edges.get(node, ()))
+        return memo[node]
+
+
+def load_ci_baseline(path=CI_BASELINE_PATH):
+    """Returns {(port, triplet): state} of ci.baseline.txt."""
+    states = {}
+    with open(path, 'r') as baseline_file:
+        for line in baseline_file:
+            match = CI_BASELINE_REGEX.match(line.strip())
+            if match:
+                states[(match.group(1), match.group(2))] = match.group(3)
+    return states
+
+
+def get_changed_files(revision):
+    output = subprocess.run(['git', '-C', ROOT_DIRECTORY, 'diff', '--name-only', revision],
+                            capture_output=True, encoding='utf-8', check=True)
+    return output.stdout.splitlines()
+
+
+def get_changed_ports(changed_files, manifests, triplets):
+    """Returns (changed ports, reason) for a list of changed files relative to the vcpkg root.
+
+    triplets are the target and host triplets which are built; a change to any of them affects all ports."""
+    changed_ports = set()
+    helper_files = []
+    for path in changed_files:
+        parts = Path(path).parts
+        if len(parts) >= 2 and parts[0] == 'ports':
+            changed_ports.add(parts[1])
+        elif NO_BUILD_IMPACT_REGEX.match(path):
+            continue
+        elif len(parts) >= 2 and parts[0] == 'triplets':
+            if Path(path).stem in triplets:
+                return set(manifests), f'{path} changed'
+        elif path.startswith('scripts/cmake/'):
+            helper_files.append(path)
+        else:
+            return set(manifests), f'{path} changed'
+    if helper_files:
+        # Only the ports which execute the changed helpers, see helperUsageReport.py.
+        sys.path.insert(0, SCRIPT_DIRECTORY)
+        from helperUsageReport import HelperGraph, ALWAYS_USED_FILES, affected_ports
+        if set(helper_files) & ALWAYS_USED_FILES:
+            return set(manifests), f'{", ".join(helper_files)} changed'
+        affected, unmapped = affected_ports(HelperGraph(), set(helper_files), sorted(manifests), {})
+        if unmapped:
+            return set(manifests), f'{", ".join(sorted(unmapped))} changed and is not known to be used by any port'
+        changed_ports |= affected
+    return changed_ports, None
+
+
+def compute_impacted(graph, changed_ports, ci_baseline):
+    """Returns {port: (state, [features])} of the impacted ports on the graph's target triplet.
+
+    The state is 'build', or why CI is not expected to install the port: 'skip' and 'fail' from
+    ci.baseline.txt, 'unsupported', or 'cascade' when a dependency is in one of these states."""
+    triplet = graph.triplet
+    impacted_features = {}
+    for port_name, feature, node_triplet in graph.impacted_nodes(changed_ports):
+        if node_triplet == triplet and feature != 'default' and port_name in graph.manifests:
+            impacted_features.setdefault(port_name, set()).add(feature)
+
+    blocked = {}
+
+    def port_state(port_name, port_triplet):
+        key = (port_name, port_triplet)
+        if key not in blocked:
+            if not graph.is_supported(port_name, 'core', port_triplet):
+                blocked[key] = 'unsupported'
+            else:
+                blocked[key] = ci_baseline.get(key) if ci_baseline.get(key) in ('fail', 'skip') else None
+        return blocked[key]
+
+    memo = {}
+    result = {}
+    for port_name, features in sorted(impacted_features.items()):
+        state = port_state(port_name, triplet)
+        if state is None and any(graph.is_blocked(dependency, port_state, memo)
+                                 for dependency in graph.edges[(port_name, 'default', triplet)]
+                                 for dependency in graph.edges[dependency] if dependency[0] != port_name):
+            state = 'cascade'
+        supported_features = sorted(feature for feature in features
+                                    if state == 'unsupported' or graph.is_supported(port_name, feature, triplet))
+        result[port_name] = (state or 'build', supported_features)
+    return result
+
+
+def default_host_triplet(triplet):
+    identifiers = get_triplet_identifiers(triplet, None)
+    if 'osx' in identifiers or 'ios' in identifiers:
+        return 'arm64-osx'
+    if 'windows' in identifiers and 'mingw' not in identifiers:
+        return 'x64-windows'
+    return 'x64-linux'
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Compute which ports, features and triplets a change affects, from the dependency graph of all ports.')
+    parser.add_argument('files', nargs='*', help='Changed files relative to the vcpkg root.')
+    parser.add_argument('--since', help='Use the files changed since this git revision.')
+    parser.add_argument('--triplet', action='append', required=True, help='Target triplet; may be repeated.')
+    parser.add_argument('--host-triplet', help='Host triplet; guessed from the target triplet by default.')
+    parser.add_argument('--ci-baseline', default=CI_BASELINE_PATH, help='ci.baseline.txt with skip and fail states.')
+    parser.add_argument('--no-cache', action='store_true', help='Read every manifest.')
+    parser.add_argument('--all-states', action='store_true', help='Also list ports which CI would not build.')
+    parser.add_argument('--json', action='store_true', help='Print JSON instead of text.')
+    args = parser.parse_args()
+
+    start_time = time.time()
+    manifests = load_manifests(not args.no_cache)
+    ci_baseline = load_ci_baseline(args.ci_baseline)
+    changed_files = list(args.files)
+    if args.since:
+        changed_files += get_changed_files(args.since)
+    host_triplets = {triplet: args.host_triplet or default_host_triplet(triplet) for triplet in args.triplet}
+    changed_ports, reason = get_changed_ports(changed_files, manifests, set(args.triplet) | set(host_triplets.values()))
+    if reason:
+        print(f'{reason}, all ports are affected', file=sys.stderr)
+
+    results = {}
+    for triplet in args.triplet:
+        graph = PortGraph(manifests, triplet, host_triplets[triplet])
+        results[triplet] = compute_impacted(graph, changed_ports, ci_baseline)
+
+    if args.json:
+        print(json.dumps({triplet: {port_name: {'state': state, 'features': features}
+                                    for port_name, (state, features) in impacted.items()}
+                          for triplet, impacted in results.items()}, indent=2))
+    else:
+        for triplet, impacted in results.items():
+            for port_name, (state, features) in impacted.items():
+                if state == 'build' or args.all_states:
+                    print(f'{port_name}[{",".join(features)}]:{triplet}' + ('' if state == 'build' else f' {state}'))
+    for triplet, impacted in results.items():
+        building = sum(1 for state, _ in impacted.values() if state == 'build')
+        print(f'{triplet}: {building} ports to build, {len(impacted) - building} impacted but not built', file=sys.stderr)
+    print(f'Elapsed time: {time.time() - start_time:.3f} seconds', file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
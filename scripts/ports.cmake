@@ -80,6 +80,7 @@ include("${SCRIPTS}/cmake/vcpkg_host_path_list.cmake")
 include("${SCRIPTS}/cmake/vcpkg_install_cmake.cmake")
 include("${SCRIPTS}/cmake/vcpkg_install_copyright.cmake")
 include("${SCRIPTS}/cmake/vcpkg_install_gn.cmake")
+include("${SCRIPTS}/cmake/vcpkg_install_header_only.cmake")
 include("${SCRIPTS}/cmake/vcpkg_install_make.cmake")
 include("${SCRIPTS}/cmake/vcpkg_install_meson.cmake")
 include("${SCRIPTS}/cmake/vcpkg_install_msbuild.cmake")
@@ -88,13 +89,19 @@ include("${SCRIPTS}/cmake/vcpkg_install_qmake.cmake")
 include("${SCRIPTS}/cmake/vcpkg_list.cmake")
 include("${SCRIPTS}/cmake/vcpkg_minimum_required.cmake")
 include("${SCRIPTS}/cmake/vcpkg_replace_string.cmake")
+include("${SCRIPTS}/cmake/vcpkg_replace_strings.cmake")
 include("${SCRIPTS}/cmake/vcpkg_test_cmake.cmake")
 
+include("${SCRIPTS}/cmake/z_vcpkg_adaptive_concurrency.cmake")
 include("${SCRIPTS}/cmake/z_vcpkg_apply_patches.cmake")
+include("${SCRIPTS}/cmake/z_vcpkg_buildtree_storage.cmake")
 include("${SCRIPTS}/cmake/z_vcpkg_forward_output_variable.cmake")
 include("${SCRIPTS}/cmake/z_vcpkg_function_arguments.cmake")
 include("${SCRIPTS}/cmake/z_vcpkg_get_cmake_vars.cmake")
+include("${SCRIPTS}/cmake/z_vcpkg_get_cmake_vars_cache.cmake")
+include("${SCRIPTS}/cmake/z_vcpkg_helper_usage.cmake")
 include("${SCRIPTS}/cmake/z_vcpkg_prettify_command_line.cmake")
+include("${SCRIPTS}/cmake/z_vcpkg_resource_usage.cmake")
 include("${SCRIPTS}/cmake/z_vcpkg_setup_pkgconfig_path.cmake")
 
 include("${SCRIPTS}/cmake/z_vcpkg_fixup_rpath.cmake")
@@ -194,6 +201,8 @@ target system or to the host system. Use a prefixed variable instead.
         variable_watch("${var}" z_vcpkg_warn_ambiguous_system_variables)
     endforeach()
 
+    z_vcpkg_helper_usage_start()
+
     if (DEFINED VCPKG_PORT_CONFIGS)
         foreach(VCPKG_PORT_CONFIG IN LISTS VCPKG_PORT_CONFIGS)
             include("${VCPKG_PORT_CONFIG}")
@@ -219,6 +228,7 @@ target system or to the host system. Use a prefixed variable instead.
             z_vcpkg_fixup_macho_rpath_in_dir()
         endif()
         include("${SCRIPTS}/build_info.cmake")
+        z_vcpkg_helper_usage_write()
     endif()
 elseif(CMD STREQUAL "CREATE")
     if(NOT DEFINED PORT_PATH)
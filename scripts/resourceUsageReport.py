@@ -0,0 +1,78 @@
+import os
+import sys
+import json
+import argparse
+
+from pathlib import Path
+
+
+SCRIPT_DIRECTORY = os.path.dirname(os.path.abspath(__file__))
+BUILDTREES_DIRECTORY = os.path.join(SCRIPT_DIRECTORY, '../buildtrees')
+
+SORT_KEYS = {
+    'memory': 'max_rss_kib',
+    'cpu': 'cpu_seconds',
+    'wall': 'wall_seconds',
+    'io': 'io_bytes',
+}
+
+
+def collect_port_usage(buildtrees_directory):
+    # Written by scripts/cmake/z_vcpkg_resource_usage.py when VCPKG_RECORD_RESOURCE_USAGE is set.
+    ports = {}
+    for summary_path in Path(buildtrees_directory).glob('*/resource-usage-*.jsonl'):
+        triplet = summary_path.stem[len('resource-usage-'):]
+        port = {
+            'port': summary_path.parent.name,
+            'triplet': triplet,
+            'steps': 0,
+            'max_rss_kib': 0,
+            'max_rss_step': '',
+            'cpu_seconds': 0.0,
+            'wall_seconds': 0.0,
+            'io_bytes': 0,
+        }
+        for line in summary_path.read_text().splitlines():
+            if not line.strip():
+                continue
+            record = json.loads(line)
+            port['steps'] += 1
+            if record['max_rss_kib'] > port['max_rss_kib']:
+                port['max_rss_kib'] = record['max_rss_kib']
+                port['max_rss_step'] = record['step']
+            port['cpu_seconds'] += record['user_seconds'] + record['system_seconds']
+            port['wall_seconds'] += record['wall_seconds']
+            port['io_bytes'] += record['read_bytes'] + record['written_bytes']
+        ports[f'{port["port"]}:{triplet}'] = port
+    return list(ports.values())
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Rank ports by the resource usage recorded with VCPKG_RECORD_RESOURCE_USAGE.')
+    parser.add_argument('buildtrees', nargs='?', default=BUILDTREES_DIRECTORY)
+    parser.add_argument('--sort', choices=sorted(SORT_KEYS), default='memory')
+    parser.add_argument('--top', type=int, default=0, help='Only print the first N ports.')
+    parser.add_argument('--json', action='store_true', help='Print the ranking as JSON.')
+    args = parser.parse_args()
+
+    ports = collect_port_usage(args.buildtrees)
+    if not ports:
+        print(f'Error: No resource usage summaries found in {args.buildtrees}', file=sys.stderr)
+        sys.exit(1)
+    ports.sort(key=lambda port: port[SORT_KEYS[args.sort]], reverse=True)
+    if args.top > 0:
+        ports = ports[:args.top]
+
+    if args.json:
+        print(json.dumps(ports, indent=2))
+        return
+    print(f'{"port":<40} {"peak RSS (MiB)":>14} {"CPU (s)":>10} {"wall (s)":>10} {"I/O (MiB)":>10}  peak step')
+    for port in ports:
+        name = f'{port["port"]}:{port["triplet"]}'
+        print(f'{name:<40} {port["max_rss_kib"] / 1024:>14.0f} {port["cpu_seconds"]:>10.1f} '
+              f'{port["wall_seconds"]:>10.1f} {port["io_bytes"] / 1048576:>10.1f}  {port["max_rss_step"]}')
+
+
+if __name__ == "__main__":
+    main()
@@ -92,6 +92,28 @@ function(get_packages out_packages cmake_version)
     set("${out_packages}" "${packages}" PARENT_SCOPE)
 endfunction()
 
+# Lists the config packages in the installed tree which CMake can find by their name.
+function(get_config_packages out_packages)
+    file(GLOB configs RELATIVE "${CURRENT_INSTALLED_DIR}/share"
+        "${CURRENT_INSTALLED_DIR}/share/*/*Config.cmake"
+        "${CURRENT_INSTALLED_DIR}/share/*/*-config.cmake"
+    )
+    set(packages "")
+    foreach(config IN LISTS configs)
+        if(config MATCHES "^([^/]*)/(.*)(Config|-config)\\.cmake$")
+            set(package "${CMAKE_MATCH_2}")
+            string(TOLOWER "${CMAKE_MATCH_1}" dir_name)
+            string(TOLOWER "${package}" package_lower)
+            string(FIND "${dir_name}" "${package_lower}" index)
+            if(index EQUAL "0")
+                list(APPEND packages "${package}")
+            endif()
+        endif()
+    endforeach()
+    list(REMOVE_DUPLICATES packages)
+    set("${out_packages}" "${packages}" PARENT_SCOPE)
+endfunction()
+
 function(test_cmake_project)
     cmake_parse_arguments(PARSE_ARGV 0 "arg" "" "CMAKE_COMMAND;NAME" "OPTIONS")
     if(NOT arg_NAME)
@@ -183,49 +205,131 @@ function(test_cmake_project)
         string(REPLACE "  CMake" "##vso[task.logissue type=error]CMake" message "${message}")
     endif()
     get_packages(packages "${cmake_version}")
+    set(index_modes OFF)
+    if("find-package-index" IN_LIST FEATURES)
+        list(APPEND index_modes ON)
+    endif()
     foreach(package IN LISTS packages)
-        string(MAKE_C_IDENTIFIER "${package}" package_string)
-        set(find_package_build_dir "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${cmake_version}-find-package-${package_string}-${arg_NAME}")
-        set(log_out "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${cmake_version}-find-package-${package_string}-${arg_NAME}-out.log")
-        set(log_err "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${cmake_version}-find-package-${package_string}-${arg_NAME}-err.log")
+        foreach(index IN LISTS index_modes)
+            string(MAKE_C_IDENTIFIER "${package}" package_string)
+            set(index_message "")
+            if(index)
+                string(APPEND package_string "-index")
+                set(index_message " with X_VCPKG_FIND_PACKAGE_INDEX")
+            endif()
+            set(find_package_build_dir "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${cmake_version}-find-package-${package_string}-${arg_NAME}")
+            set(log_out "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${cmake_version}-find-package-${package_string}-${arg_NAME}-out.log")
+            set(log_err "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${cmake_version}-find-package-${package_string}-${arg_NAME}-err.log")
 
-        message(STATUS "  find_package(${package})")
-        file(REMOVE_RECURSE "${find_package_build_dir}")
-        file(MAKE_DIRECTORY "${find_package_build_dir}")
-        execute_process(
-            COMMAND
-                "${arg_CMAKE_COMMAND}" "${CMAKE_CURRENT_LIST_DIR}/project"
-                ${base_options}
-                ${arg_OPTIONS}
-                "-DFIND_PACKAGES=${package}"
-                --trace-expand
-            OUTPUT_FILE "${log_out}"
-            ERROR_FILE "${log_err}"
-            RESULT_VARIABLE package_result
-            WORKING_DIRECTORY "${find_package_build_dir}"
-        )
-        if(package_result)
-            set(step "configuration")
-            string(CONFIGURE "${message}" package_message @ONLY)
-            message(SEND_ERROR "${package_message}")
-        else()
-            set(log_out "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${cmake_version}-find-package-${package_string}-${arg_NAME}-build-out.log")
-            set(log_err "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${cmake_version}-find-package-${package_string}-${arg_NAME}-build-err.log")
+            message(STATUS "  find_package(${package})${index_message}")
+            file(REMOVE_RECURSE "${find_package_build_dir}")
+            file(MAKE_DIRECTORY "${find_package_build_dir}")
             execute_process(
                 COMMAND
-                    "${arg_CMAKE_COMMAND}" --build .
+                    "${arg_CMAKE_COMMAND}" "${CMAKE_CURRENT_LIST_DIR}/project"
+                    ${base_options}
+                    ${arg_OPTIONS}
+                    "-DFIND_PACKAGES=${package}"
+                    "-DX_VCPKG_FIND_PACKAGE_INDEX=${index}"
+                    --trace-expand
                 OUTPUT_FILE "${log_out}"
                 ERROR_FILE "${log_err}"
                 RESULT_VARIABLE package_result
                 WORKING_DIRECTORY "${find_package_build_dir}"
             )
             if(package_result)
-                set(step "build")
+                set(step "configuration")
                 string(CONFIGURE "${message}" package_message @ONLY)
                 message(SEND_ERROR "${package_message}")
+            else()
+                set(log_out "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${cmake_version}-find-package-${package_string}-${arg_NAME}-build-out.log")
+                set(log_err "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${cmake_version}-find-package-${package_string}-${arg_NAME}-build-err.log")
+                execute_process(
+                    COMMAND
+                        "${arg_CMAKE_COMMAND}" --build .
+                    OUTPUT_FILE "${log_out}"
+                    ERROR_FILE "${log_err}"
+                    RESULT_VARIABLE package_result
+                    WORKING_DIRECTORY "${find_package_build_dir}"
+                )
+                if(package_result)
+                    set(step "build")
+                    string(CONFIGURE "${message}" package_message @ONLY)
+                    message(SEND_ERROR "${package_message}")
+                endif()
             endif()
-        endif()
+        endforeach()
     endforeach()
+
+    if("find-package-benchmark" IN_LIST FEATURES)
+        # Configure time of find_package() for every config package, with the default search,
+        # with X_VCPKG_FIND_PACKAGE_INDEX, and with X_VCPKG_CONSOLIDATED_CONFIGS.
+        get_config_packages(packages)
+        list(LENGTH packages packages_count)
+        set(benchmark_build_dir "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${cmake_version}-find-package-benchmark-${arg_NAME}")
+        string(REPLACE ";" "\n" packages_text "${packages}")
+        file(WRITE "${benchmark_build_dir}-packages.txt" "${packages_text}\n")
+        message(STATUS "  find_package() benchmark with ${packages_count} packages")
+        foreach(mode IN ITEMS search index consolidated)
+            set(mode_options "-DX_VCPKG_FIND_PACKAGE_INDEX=OFF" "-DX_VCPKG_CONSOLIDATED_CONFIGS=OFF")
+            if(mode STREQUAL "index")
+                set(mode_options "-DX_VCPKG_FIND_PACKAGE_INDEX=ON" "-DX_VCPKG_CONSOLIDATED_CONFIGS=OFF")
+            elseif(mode STREQUAL "consolidated")
+                set(mode_options "-DX_VCPKG_FIND_PACKAGE_INDEX=ON" "-DX_VCPKG_CONSOLIDATED_CONFIGS=ON")
+            endif()
+            file(REMOVE_RECURSE "${benchmark_build_dir}")
+            file(MAKE_DIRECTORY "${benchmark_build_dir}")
+            foreach(step IN ITEMS configure reconfigure)
+                string(TIMESTAMP start "%s%f")
+                vcpkg_execute_required_process(
+                    COMMAND
+                        "${arg_CMAKE_COMMAND}" "${CMAKE_CURRENT_LIST_DIR}/project"
+                        ${base_options}
+                        ${arg_OPTIONS}
+                        "-DBENCHMARK_PACKAGES_FILE=${benchmark_build_dir}-packages.txt"
+                        ${mode_options}
+                    WORKING_DIRECTORY "${benchmark_build_dir}"
+                    LOGNAME "${TARGET_TRIPLET}-${cmake_version}-find-package-benchmark-${arg_NAME}-${mode}-${step}"
+                )
+                string(TIMESTAMP end "%s%f")
+                math(EXPR milliseconds "(${end} - ${start}) / 1000")
+                message(STATUS "    ${mode} ${step}: ${milliseconds} ms")
+            endforeach()
+        endforeach()
+    endif()
+
+    if("toolchain-benchmark" IN_LIST FEATURES AND cmake_version VERSION_GREATER_EQUAL "3.23") # string(TIMESTAMP) %f
+        # Time spent in the overridden commands, with plain CMake, vcpkg.cmake, and vcpkg.cmake in low-overhead mode.
+        get_config_packages(packages)
+        set(benchmark_build_dir "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${cmake_version}-toolchain-benchmark-${arg_NAME}")
+        string(REPLACE ";" "\n" packages_text "${packages}")
+        file(WRITE "${benchmark_build_dir}-packages.txt" "${packages_text}\n")
+        set(plain_options "${base_options}")
+        list(FILTER plain_options EXCLUDE REGEX "^-DCMAKE_TOOLCHAIN_FILE=")
+        list(APPEND plain_options "-DCMAKE_TOOLCHAIN_FILE=${VCPKG_CHAINLOAD_TOOLCHAIN_FILE}" "-DCMAKE_PREFIX_PATH=${CURRENT_INSTALLED_DIR}")
+        set(toolchain_options ${base_options})
+        set(low_overhead_options ${base_options} "-DX_VCPKG_LOW_OVERHEAD=ON")
+        message(STATUS "  Toolchain overhead benchmark")
+        foreach(mode IN ITEMS plain toolchain low_overhead)
+            file(REMOVE_RECURSE "${benchmark_build_dir}")
+            file(MAKE_DIRECTORY "${benchmark_build_dir}")
+            vcpkg_execute_required_process(
+                COMMAND
+                    "${arg_CMAKE_COMMAND}" "${CMAKE_CURRENT_LIST_DIR}/benchmark"
+                    ${${mode}_options}
+                    ${arg_OPTIONS}
+                    "-DBENCHMARK_PACKAGES_FILE=${benchmark_build_dir}-packages.txt"
+                WORKING_DIRECTORY "${benchmark_build_dir}"
+                LOGNAME "${TARGET_TRIPLET}-${cmake_version}-toolchain-benchmark-${arg_NAME}-${mode}"
+                OUTPUT_VARIABLE benchmark_output
+            )
+            string(REGEX MATCHALL "benchmark: [^\n]*" results "${benchmark_output}")
+            foreach(result IN LISTS results)
+                string(REPLACE "benchmark: " "" result "${result}")
+                message(STATUS "    ${mode}: ${result}")
+            endforeach()
+        endforeach()
+    endif()
 endfunction()
 
 if(NOT DEFINED VCPKG_CHAINLOAD_TOOLCHAIN_FILE)
@@ -21,9 +21,18 @@ endif()
 if("merge-libs" IN_LIST FEATURES)
     include("${CMAKE_CURRENT_LIST_DIR}/test-z_vcpkg_cmake_config_fixup_merge.cmake")
 endif()
+if("cmake-config-fixup" IN_LIST FEATURES)
+    include("${CMAKE_CURRENT_LIST_DIR}/test-vcpkg_cmake_config_fixup.cmake")
+endif()
+if("cmake-config-consolidate" IN_LIST FEATURES)
+    include("${CMAKE_CURRENT_LIST_DIR}/test-vcpkg_cmake_config_consolidate.cmake")
+endif()
 if("backup-restore-env-vars" IN_LIST FEATURES)
     include("${CMAKE_CURRENT_LIST_DIR}/test-vcpkg_backup_restore_env_vars.cmake")
 endif()
+if("replace-strings" IN_LIST FEATURES)
+    include("${CMAKE_CURRENT_LIST_DIR}/test-vcpkg_replace_strings.cmake")
+endif()
 if("setup-pkgconfig-path" IN_LIST FEATURES)
     include("${CMAKE_CURRENT_LIST_DIR}/test-z_vcpkg_setup_pkgconfig_path.cmake")
 endif()
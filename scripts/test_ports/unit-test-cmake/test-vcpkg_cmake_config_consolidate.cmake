@@ -0,0 +1,116 @@
+# vcpkg_cmake_config_consolidate(PACKAGE_NAMES <name>...)
+set(saved_packages_dir "${CURRENT_PACKAGES_DIR}")
+set(CURRENT_PACKAGES_DIR "${CURRENT_BUILDTREES_DIR}/test-vcpkg_cmake_config_consolidate")
+
+function(read_file out_var file)
+    if(EXISTS "${file}")
+        file(READ "${file}" contents)
+    else()
+        set(contents "<missing>")
+    endif()
+    set("${out_var}" "${contents}" PARENT_SCOPE)
+endfunction()
+
+# The parts of a targets file written by install(EXPORT) which are relevant for consolidation.
+function(write_config_package name)
+    set(config_dir "${CURRENT_PACKAGES_DIR}/share/${name}")
+    file(WRITE "${config_dir}/${name}Config.cmake" "include(CMakeFindDependencyMacro)
+include(\"\${CMAKE_CURRENT_LIST_DIR}/${name}Targets.cmake\")
+include(\"\${CMAKE_CURRENT_LIST_DIR}/${name}Macros.cmake\")
+")
+    file(WRITE "${config_dir}/${name}ConfigVersion.cmake" "set(PACKAGE_VERSION \"1.0\")\n")
+    file(WRITE "${config_dir}/${name}Macros.cmake" "macro(${name}_add_plugin)\nendmacro()\n")
+    file(WRITE "${config_dir}/${name}Targets.cmake" "cmake_policy(PUSH)
+#----------------------------------------------------------------
+# Generated CMake target import file.
+#----------------------------------------------------------------
+foreach(_cmake_expected_target IN ITEMS ${name}::${name})
+  list(APPEND _cmake_expected_targets \"\${_cmake_expected_target}\")
+endforeach()
+if(TARGET ${name}::${name})
+  cmake_policy(POP)
+  return()
+endif()
+get_filename_component(_IMPORT_PREFIX \"\${CMAKE_CURRENT_LIST_DIR}/../../\" ABSOLUTE)
+add_library(${name}::${name} STATIC IMPORTED)
+set_target_properties(${name}::${name} PROPERTIES INTERFACE_LINK_LIBRARIES \"a;\$<\$<CONFIG:DEBUG>:b>\")
+
+# Load information for each installed configuration.
+file(GLOB _cmake_config_files \"\${CMAKE_CURRENT_LIST_DIR}/${name}Targets-*.cmake\")
+foreach(_cmake_config_file IN LISTS _cmake_config_files)
+  include(\"\${_cmake_config_file}\")
+endforeach()
+unset(_cmake_config_file)
+unset(_cmake_config_files)
+set(_IMPORT_PREFIX)
+cmake_policy(POP)
+")
+    file(WRITE "${config_dir}/${name}Targets-release.cmake" "set_property(TARGET ${name}::${name} APPEND PROPERTY IMPORTED_CONFIGURATIONS RELEASE)\n")
+    file(WRITE "${config_dir}/${name}Targets-debug.cmake" "set_property(TARGET ${name}::${name} APPEND PROPERTY IMPORTED_CONFIGURATIONS DEBUG)\n")
+endfunction()
+
+file(REMOVE_RECURSE "${CURRENT_PACKAGES_DIR}")
+write_config_package(alpha)
+write_config_package(beta)
+# A return() which cannot be turned into break()
+file(READ "${CURRENT_PACKAGES_DIR}/share/beta/betaTargets.cmake" contents)
+string(REPLACE "  list(APPEND" "  return()\n  list(APPEND" contents "${contents}")
+file(WRITE "${CURRENT_PACKAGES_DIR}/share/beta/betaTargets.cmake" "${contents}")
+unit_test_ensure_success([[vcpkg_cmake_config_consolidate(PACKAGE_NAMES alpha beta)]])
+
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/share/alpha/alpha-consolidated.cmake")]] contents [[
+include(CMakeFindDependencyMacro)
+# Inlined alphaTargets.cmake
+foreach(z_vcpkg_consolidated_block IN ITEMS alphaTargets.cmake)
+cmake_policy(PUSH)
+#----------------------------------------------------------------
+# Generated CMake target import file.
+#----------------------------------------------------------------
+foreach(_cmake_expected_target IN ITEMS alpha::alpha)
+  list(APPEND _cmake_expected_targets "${_cmake_expected_target}")
+endforeach()
+if(TARGET alpha::alpha)
+  cmake_policy(POP)
+  break()
+endif()
+get_filename_component(_IMPORT_PREFIX "${CMAKE_CURRENT_LIST_DIR}/../../" ABSOLUTE)
+add_library(alpha::alpha STATIC IMPORTED)
+set_target_properties(alpha::alpha PROPERTIES INTERFACE_LINK_LIBRARIES "a;$<$<CONFIG:DEBUG>:b>")
+
+# Load information for each installed configuration.
+# Inlined alphaTargets-debug.cmake
+set_property(TARGET alpha::alpha APPEND PROPERTY IMPORTED_CONFIGURATIONS DEBUG)
+# Inlined alphaTargets-release.cmake
+set_property(TARGET alpha::alpha APPEND PROPERTY IMPORTED_CONFIGURATIONS RELEASE)
+unset(_cmake_config_file)
+unset(_cmake_config_files)
+set(_IMPORT_PREFIX)
+cmake_policy(POP)
+
+endforeach()
+unset(z_vcpkg_consolidated_block)
+include("${CMAKE_CURRENT_LIST_DIR}/alphaMacros.cmake")
+]])
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/share/alpha/alpha-consolidated-version.cmake")]] contents "set(PACKAGE_VERSION \"1.0\")\n")
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/share/beta/beta-consolidated.cmake")]] contents "<missing>")
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/share/beta/beta-consolidated-version.cmake")]] contents "<missing>")
+
+# Packages without a config file are skipped
+unit_test_ensure_success([[vcpkg_cmake_config_consolidate(PACKAGE_NAMES gamma)]])
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/share/gamma/gamma-consolidated.cmake")]] contents "<missing>")
+
+# Targets files in subdirectories of the config directory are not inlined
+write_config_package(delta)
+set(delta_dir "${CURRENT_PACKAGES_DIR}/share/delta")
+file(GLOB delta_targets "${delta_dir}/deltaTargets*.cmake")
+file(COPY ${delta_targets} DESTINATION "${delta_dir}/export")
+file(REMOVE ${delta_targets})
+file(WRITE "${delta_dir}/deltaConfig.cmake" "include(\"\${CMAKE_CURRENT_LIST_DIR}/export/deltaTargets.cmake\")\n")
+unit_test_ensure_success([[vcpkg_cmake_config_consolidate(PACKAGE_NAMES delta)]])
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/share/delta/delta-consolidated.cmake")]] contents "<missing>")
+
+unit_test_ensure_fatal_error([[vcpkg_cmake_config_consolidate(alpha)]])
+unit_test_ensure_fatal_error([[vcpkg_cmake_config_consolidate()]])
+
+file(REMOVE_RECURSE "${CURRENT_PACKAGES_DIR}")
+set(CURRENT_PACKAGES_DIR "${saved_packages_dir}")
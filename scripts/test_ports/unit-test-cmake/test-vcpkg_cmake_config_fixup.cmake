@@ -0,0 +1,153 @@
+# vcpkg_cmake_config_fixup([PACKAGE_NAME <name>] [CONFIG_PATH <path>] [PACKAGE_NAMES <name>... [CONFIG_PATHS <path>...]] ...)
+set(saved_packages_dir "${CURRENT_PACKAGES_DIR}")
+set(saved_build_type "${VCPKG_BUILD_TYPE}")
+set(saved_installed_dir "${CURRENT_INSTALLED_DIR}")
+unset(VCPKG_BUILD_TYPE)
+set(CURRENT_INSTALLED_DIR "/vcpkg/installed/unit-test")
+
+function(read_file out_var file)
+    if(EXISTS "${file}")
+        file(READ "${file}" contents)
+    else()
+        set(contents "<missing>")
+    endif()
+    set("${out_var}" "${contents}" PARENT_SCOPE)
+endfunction()
+
+function(write_config_package config_path name)
+    set(targets [[
+# Generated CMake target import file.
+get_filename_component(_IMPORT_PREFIX "${CMAKE_CURRENT_LIST_FILE}" PATH)
+get_filename_component(_IMPORT_PREFIX "${_IMPORT_PREFIX}" PATH)
+get_filename_component(_IMPORT_PREFIX "${_IMPORT_PREFIX}" PATH)
+get_filename_component(_IMPORT_PREFIX "${_IMPORT_PREFIX}" PATH)
+add_library(@name@::@name@ STATIC IMPORTED)
+set_target_properties(@name@::@name@ PROPERTIES
+  INTERFACE_INCLUDE_DIRECTORIES "${_IMPORT_PREFIX}/include"
+  INTERFACE_LINK_LIBRARIES "common;@lib@"
+)
+]])
+    set(release_lib "${CURRENT_INSTALLED_DIR}/lib/libz.a")
+    set(debug_lib "${CURRENT_INSTALLED_DIR}/debug/lib/libzd.a")
+    set(release_targets [[
+# Generated CMake target import file for configuration "Release".
+set_property(TARGET @name@::tool APPEND PROPERTY IMPORTED_LOCATION_RELEASE "${_IMPORT_PREFIX}/bin/@name@-tool")
+set_property(TARGET @name@::@name@ APPEND PROPERTY IMPORTED_LOCATION_RELEASE "@prefix@/lib/lib@name@.a")
+]])
+    set(debug_targets [[
+# Generated CMake target import file for configuration "Debug".
+set_property(TARGET @name@::tool APPEND PROPERTY IMPORTED_LOCATION_DEBUG "${_IMPORT_PREFIX}/bin/@name@-tool")
+set_property(TARGET @name@::@name@ APPEND PROPERTY IMPORTED_LOCATION_DEBUG "@prefix@/lib/lib@name@d.a")
+]])
+    set(config [[
+get_filename_component(PACKAGE_PREFIX_DIR "${CMAKE_CURRENT_LIST_DIR}/../../../" ABSOLUTE)
+include("${CMAKE_CURRENT_LIST_DIR}/@name@Targets.cmake")
+set(@name@_INCLUDE_DIR "@packages@/include")
+]])
+    set(prefix "${CURRENT_INSTALLED_DIR}")
+    set(packages "${CURRENT_PACKAGES_DIR}")
+    set(lib "${release_lib}")
+    string(CONFIGURE "${targets}" contents @ONLY)
+    file(WRITE "${CURRENT_PACKAGES_DIR}/${config_path}/${name}Targets.cmake" "${contents}")
+    string(CONFIGURE "${release_targets}" contents @ONLY)
+    file(WRITE "${CURRENT_PACKAGES_DIR}/${config_path}/${name}Targets-release.cmake" "${contents}")
+    string(CONFIGURE "${config}" contents @ONLY)
+    file(WRITE "${CURRENT_PACKAGES_DIR}/${config_path}/${name}Config.cmake" "${contents}")
+    file(WRITE "${CURRENT_PACKAGES_DIR}/${config_path}/modules/Find${name}Helper.cmake" "# module\n")
+
+    set(lib "${debug_lib}")
+    string(CONFIGURE "${targets}" contents @ONLY)
+    file(WRITE "${CURRENT_PACKAGES_DIR}/debug/${config_path}/${name}Targets.cmake" "${contents}")
+    set(prefix "${CURRENT_INSTALLED_DIR}/debug")
+    string(CONFIGURE "${debug_targets}" contents @ONLY)
+    file(WRITE "${CURRENT_PACKAGES_DIR}/debug/${config_path}/${name}Targets-debug.cmake" "${contents}")
+    file(WRITE "${CURRENT_PACKAGES_DIR}/debug/${config_path}/${name}Config.cmake" "# debug config\n")
+    file(WRITE "${CURRENT_PACKAGES_DIR}/debug/${config_path}/modules/Find${name}Helper.cmake" "# module\n")
+endfunction()
+
+# Lists "<relative path>: <contents>" of all files below CURRENT_PACKAGES_DIR.
+function(read_package_tree out_var)
+    file(GLOB_RECURSE files RELATIVE "${CURRENT_PACKAGES_DIR}" "${CURRENT_PACKAGES_DIR}/*")
+    set(tree "")
+    foreach(file IN LISTS files)
+        file(READ "${CURRENT_PACKAGES_DIR}/${file}" contents)
+        string(APPEND tree "${file}: ${contents}\n")
+    endforeach()
+    set("${out_var}" "${tree}" PARENT_SCOPE)
+endfunction()
+
+# Golden output of a batched fixup of two packages.
+set(CURRENT_PACKAGES_DIR "${CURRENT_BUILDTREES_DIR}/test-vcpkg_cmake_config_fixup-batched")
+file(REMOVE_RECURSE "${CURRENT_PACKAGES_DIR}")
+write_config_package(lib/cmake/alpha-1.0 alpha)
+write_config_package(lib/cmake/beta-1.0 beta)
+unit_test_ensure_success([[
+    vcpkg_cmake_config_fixup(
+        PACKAGE_NAMES alpha beta
+        CONFIG_PATHS lib/cmake/alpha-1.0 lib/cmake/beta-1.0
+        TOOLS_PATH tools/unit-test
+    )
+]])
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/share/alpha/alphaTargets.cmake")]] contents [[
+get_filename_component(VCPKG_IMPORT_PREFIX "${CMAKE_CURRENT_LIST_DIR}/../../" ABSOLUTE)
+# Generated CMake target import file.
+get_filename_component(_IMPORT_PREFIX "${CMAKE_CURRENT_LIST_FILE}" PATH)
+get_filename_component(_IMPORT_PREFIX "${_IMPORT_PREFIX}" PATH)
+get_filename_component(_IMPORT_PREFIX "${_IMPORT_PREFIX}" PATH)
+add_library(alpha::alpha STATIC IMPORTED)
+set_target_properties(alpha::alpha PROPERTIES
+  INTERFACE_INCLUDE_DIRECTORIES "${_IMPORT_PREFIX}/include"
+  INTERFACE_LINK_LIBRARIES "common;\$<\$<NOT:\$<CONFIG:DEBUG>>:${VCPKG_IMPORT_PREFIX}/lib/libz.a>;\$<\$<CONFIG:DEBUG>:${VCPKG_IMPORT_PREFIX}/debug/lib/libzd.a>"
+)
+]])
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/share/alpha/alphaTargets-release.cmake")]] contents [[
+# Generated CMake target import file for configuration "Release".
+set_property(TARGET alpha::tool APPEND PROPERTY IMPORTED_LOCATION_RELEASE "${_IMPORT_PREFIX}/tools/unit-test/alpha-tool")
+set_property(TARGET alpha::alpha APPEND PROPERTY IMPORTED_LOCATION_RELEASE "${_IMPORT_PREFIX}/lib/libalpha.a")
+]])
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/share/beta/betaTargets-debug.cmake")]] contents [[
+# Generated CMake target import file for configuration "Debug".
+set_property(TARGET beta::tool APPEND PROPERTY IMPORTED_LOCATION_DEBUG "${_IMPORT_PREFIX}/tools/unit-test/beta-tool")
+set_property(TARGET beta::beta APPEND PROPERTY IMPORTED_LOCATION_DEBUG "${_IMPORT_PREFIX}/debug/lib/libbetad.a")
+]])
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/share/beta/betaConfig.cmake")]] contents [[
+get_filename_component(VCPKG_IMPORT_PREFIX "${CMAKE_CURRENT_LIST_DIR}/../../" ABSOLUTE)
+get_filename_component(PACKAGE_PREFIX_DIR "${CMAKE_CURRENT_LIST_DIR}/../../" ABSOLUTE)
+include("${CMAKE_CURRENT_LIST_DIR}/betaTargets.cmake")
+set(beta_INCLUDE_DIR "${VCPKG_IMPORT_PREFIX}/include")
+]])
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/share/beta/modules/FindbetaHelper.cmake")]] contents "# module\n")
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/share/beta/betaTargets-release.cmake")]] contents [[
+# Generated CMake target import file for configuration "Release".
+set_property(TARGET beta::tool APPEND PROPERTY IMPORTED_LOCATION_RELEASE "${_IMPORT_PREFIX}/tools/unit-test/beta-tool")
+set_property(TARGET beta::beta APPEND PROPERTY IMPORTED_LOCATION_RELEASE "${_IMPORT_PREFIX}/lib/libbeta.a")
+]])
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/debug/share/beta/modules/FindbetaHelper.cmake")]] contents "# module\n")
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/debug/share/beta/betaConfig.cmake")]] contents "<missing>")
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/lib/cmake/alpha-1.0/alphaConfig.cmake")]] contents "<missing>")
+unit_test_check_variable_equal([[read_file(contents "${CURRENT_PACKAGES_DIR}/debug/lib/cmake/beta-1.0/betaTargets.cmake")]] contents "<missing>")
+read_package_tree(batched_tree)
+
+# Calling vcpkg_cmake_config_fixup for each package gives the same result.
+set(CURRENT_PACKAGES_DIR "${CURRENT_BUILDTREES_DIR}/test-vcpkg_cmake_config_fixup-sequential")
+file(REMOVE_RECURSE "${CURRENT_PACKAGES_DIR}")
+write_config_package(lib/cmake/alpha-1.0 alpha)
+write_config_package(lib/cmake/beta-1.0 beta)
+vcpkg_cmake_config_fixup(PACKAGE_NAME alpha CONFIG_PATH lib/cmake/alpha-1.0 TOOLS_PATH tools/unit-test DO_NOT_DELETE_PARENT_CONFIG_PATH)
+vcpkg_cmake_config_fixup(PACKAGE_NAME beta CONFIG_PATH lib/cmake/beta-1.0 TOOLS_PATH tools/unit-test)
+string(REPLACE "-batched/" "-sequential/" batched_tree "${batched_tree}")
+unit_test_check_variable_equal([[read_package_tree(sequential_tree)]] sequential_tree "${batched_tree}")
+
+# Package names and config paths must match up.
+unit_test_ensure_fatal_error([[vcpkg_cmake_config_fixup(PACKAGE_NAMES alpha beta CONFIG_PATHS lib/cmake/alpha-1.0)]])
+unit_test_ensure_fatal_error([[vcpkg_cmake_config_fixup(PACKAGE_NAME alpha PACKAGE_NAMES beta)]])
+
+file(REMOVE_RECURSE
+    "${CURRENT_BUILDTREES_DIR}/test-vcpkg_cmake_config_fixup-batched"
+    "${CURRENT_BUILDTREES_DIR}/test-vcpkg_cmake_config_fixup-sequential"
+)
+set(CURRENT_PACKAGES_DIR "${saved_packages_dir}")
+set(CURRENT_INSTALLED_DIR "${saved_installed_dir}")
+if(NOT saved_build_type STREQUAL "")
+    set(VCPKG_BUILD_TYPE "${saved_build_type}")
+endif()
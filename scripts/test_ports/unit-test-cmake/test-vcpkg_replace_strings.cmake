@@ -0,0 +1,44 @@
+# vcpkg_replace_strings(FILES <file>... [REPLACE <match> <replace>]... [REGEX_REPLACE <regex> <replace>]... [IGNORE_UNCHANGED])
+# vcpkg_replace_string(<file> <match> <replace> [REGEX] [IGNORE_UNCHANGED])
+
+set(file_a "${CURRENT_BUILDTREES_DIR}/test-vcpkg_replace_strings-a.txt")
+set(file_b "${CURRENT_BUILDTREES_DIR}/test-vcpkg_replace_strings-b.txt")
+
+function(read_file out_var file)
+    file(READ "${file}" contents)
+    set("${out_var}" "${contents}" PARENT_SCOPE)
+endfunction()
+
+# Replacements are applied in order, to all files.
+file(WRITE "${file_a}" "#define A 1\n#define B 2\n")
+file(WRITE "${file_b}" "#define B 2\n")
+vcpkg_replace_strings(FILES "${file_a}" "${file_b}"
+    REPLACE "#define B 2" "#define B 3"
+    REGEX_REPLACE "define ([AB]) 3" "define \\1 4"
+    IGNORE_UNCHANGED
+)
+unit_test_check_variable_equal([[read_file(contents "${file_a}")]] contents "#define A 1\n#define B 4\n")
+unit_test_check_variable_equal([[read_file(contents "${file_b}")]] contents "#define B 4\n")
+
+# Semicolons and empty replacements are preserved.
+file(WRITE "${file_a}" "a;b;c")
+vcpkg_replace_strings(FILES "${file_a}" REPLACE "a;b" "" REPLACE "c" "x;y")
+unit_test_check_variable_equal([[read_file(contents "${file_a}")]] contents ";x;y")
+
+# Files without any match are not rewritten.
+file(WRITE "${file_b}" "unchanged")
+file(TIMESTAMP "${file_b}" timestamp_before "%Y-%m-%dT%H:%M:%S.%f" UTC)
+vcpkg_replace_strings(FILES "${file_b}" REPLACE "missing" "found" IGNORE_UNCHANGED)
+unit_test_check_variable_equal([[file(TIMESTAMP "${file_b}" timestamp_after "%Y-%m-%dT%H:%M:%S.%f" UTC)]] timestamp_after "${timestamp_before}")
+
+# Wrapper
+file(WRITE "${file_a}" "version = 1.0")
+vcpkg_replace_string("${file_a}" "1.0" "2.0")
+unit_test_check_variable_equal([[read_file(contents "${file_a}")]] contents "version = 2.0")
+vcpkg_replace_string("${file_a}" "[0-9]+\\.[0-9]+" "3.0" REGEX)
+unit_test_check_variable_equal([[read_file(contents "${file_a}")]] contents "version = 3.0")
+
+unit_test_ensure_fatal_error([[ vcpkg_replace_strings(REPLACE "a" "b") ]])
+unit_test_ensure_fatal_error([[ vcpkg_replace_strings(FILES "${file_a}" REPLACE "a") ]])
+
+file(REMOVE "${file_a}" "${file_b}")